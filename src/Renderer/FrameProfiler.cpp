@@ -0,0 +1,171 @@
+#include "FrameProfiler.h"
+#include <QFile>
+#include <QTextStream>
+#include <algorithm>
+#include <vector>
+
+namespace {
+    const char *const kPassNames[] = {"upload", "grid", "model", "light", "frame"};
+
+    double msSince(std::chrono::steady_clock::time_point t) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t).count();
+    }
+}
+
+const char *FrameProfiler::passName(int pass) {
+    return kPassNames[pass];
+}
+
+void FrameProfiler::initialize(QOpenGLFunctions_4_1_Core *gl) {
+    gl_ = gl;
+    gl_->glGenQueries(static_cast<GLsizei>(kLatency * PassCount), &queries_[0][0]);
+}
+
+void FrameProfiler::release() {
+    if (!gl_) return;
+    gl_->glDeleteQueries(static_cast<GLsizei>(kLatency * PassCount), &queries_[0][0]);
+    gl_ = nullptr;
+}
+
+void FrameProfiler::reset() {
+    // frame_ 은 계속 셈 → 이전 프레임의 쿼리는 collect 에서 live 가 아니게 됨
+    for (Frame &f : history_) f = Frame();
+    lastDraws_ = lastTriangles_ = 0;
+}
+
+void FrameProfiler::beginFrame() {
+    ++frame_;
+    const size_t slot = frame_ % kLatency;
+    if (queryFrame_[slot]) collect(slot); // kLatency 프레임 전 쿼리
+
+    Frame &f = history_[frame_ % kHistory];
+    f = Frame();
+    f.index = frame_;
+    std::fill(std::begin(f.gpu), std::end(f.gpu), -1.0);
+    frameStart_ = Clock::now();
+}
+
+void FrameProfiler::endFrame() {
+    Frame &f = history_[frame_ % kHistory];
+    f.cpu[PassCount] = msSince(frameStart_);
+    queryFrame_[frame_ % kLatency] = frame_;
+    lastDraws_ = f.draws;
+    lastTriangles_ = f.triangles;
+}
+
+void FrameProfiler::beginPass(Pass p) {
+    const size_t slot = frame_ % kLatency;
+    if (gl_) {
+        gl_->glBeginQuery(GL_TIME_ELAPSED, queries_[slot][p]);
+        issued_[slot][p] = true;
+    }
+    passStart_[p] = Clock::now();
+}
+
+void FrameProfiler::endPass(Pass p) {
+    history_[frame_ % kHistory].cpu[p] = msSince(passStart_[p]);
+    if (gl_) gl_->glEndQuery(GL_TIME_ELAPSED);
+}
+
+void FrameProfiler::countDraws(size_t draws, size_t triangles) {
+    Frame &f = history_[frame_ % kHistory];
+    f.draws += static_cast<uint32_t>(draws);
+    f.triangles += triangles;
+}
+
+void FrameProfiler::collect(size_t slot) {
+    Frame &f = history_[queryFrame_[slot] % kHistory];
+    const bool live = f.index == queryFrame_[slot];
+    double total = 0.0;
+    bool complete = true;
+    for (int p = 0; p < PassCount; ++p) {
+        if (!issued_[slot][p]) continue;
+        issued_[slot][p] = false;
+        // 아직 안 끝났으면 그 프레임 값은 버림 (GL_QUERY_RESULT 를 바로 읽으면 GPU 를 기다리게 됨)
+        GLuint available = 0;
+        gl_->glGetQueryObjectuiv(queries_[slot][p], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            complete = false;
+            continue;
+        }
+        GLuint64 ns = 0;
+        gl_->glGetQueryObjectui64v(queries_[slot][p], GL_QUERY_RESULT, &ns);
+        if (live) f.gpu[p] = ns / 1e6;
+        total += ns / 1e6;
+    }
+    if (live && complete) f.gpu[PassCount] = total;
+    queryFrame_[slot] = 0;
+}
+
+template<class Get>
+FrameProfiler::Stats FrameProfiler::stats(Get &&get) const {
+    std::vector<double> v;
+    v.reserve(kHistory);
+    for (const Frame &f : history_) {
+        if (f.index == 0) continue;
+        const double x = get(f);
+        if (x >= 0.0) v.push_back(x);
+    }
+    Stats s;
+    s.samples = v.size();
+    if (v.empty()) return s;
+
+    double sum = 0.0;
+    for (double x : v) sum += x;
+    s.avg = sum / v.size();
+    s.min = *std::min_element(v.begin(), v.end());
+    auto p99 = v.begin() + static_cast<ptrdiff_t>((v.size() - 1) * 99 / 100);
+    std::nth_element(v.begin(), p99, v.end());
+    s.p99 = *p99;
+    return s;
+}
+
+FrameProfiler::Stats FrameProfiler::cpuStats(int pass) const {
+    return stats([pass](const Frame &f) { return f.cpu[pass]; });
+}
+
+FrameProfiler::Stats FrameProfiler::gpuStats(int pass) const {
+    return stats([pass](const Frame &f) { return f.gpu[pass]; });
+}
+
+QString FrameProfiler::summary() const {
+    auto fmt = [](const Stats &s) {
+        if (!s.samples) return QStringLiteral("    -");
+        return QString("%1 %2 %3").arg(s.min, 6, 'f', 2).arg(s.avg, 6, 'f', 2).arg(s.p99, 6, 'f', 2);
+    };
+    QString text = QString("%1  %2  %3\n")
+            .arg(QString(), -6).arg(QLatin1String("CPU min avg p99"), -22).arg(QLatin1String("GPU min avg p99"));
+    for (int p : {int(PassCount), int(Upload), int(Grid), int(Model), int(Light)}) {
+        text += QString("%1  %2  %3\n").arg(QLatin1String(kPassNames[p]), -6)
+                .arg(fmt(cpuStats(p)), -22).arg(fmt(gpuStats(p)));
+    }
+    text += QString("%1 triangles, %2 draws (ms, last %3 frames)")
+            .arg(lastTriangles_).arg(lastDraws_).arg(std::min<uint64_t>(frame_, kHistory));
+    return text;
+}
+
+bool FrameProfiler::exportCsv(const QString &path) const {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) return false;
+    QTextStream out(&file);
+
+    out << "frame";
+    for (int p = 0; p <= PassCount; ++p) out << ",cpu_" << kPassNames[p] << "_ms";
+    for (int p = 0; p <= PassCount; ++p) out << ",gpu_" << kPassNames[p] << "_ms";
+    out << ",triangles,draws\n";
+
+    // 링 버퍼를 오래된 프레임부터
+    const uint64_t first = frame_ >= kHistory ? frame_ - kHistory + 1 : 1;
+    for (uint64_t i = first; i <= frame_; ++i) {
+        const Frame &f = history_[i % kHistory];
+        if (f.index != i) continue;
+        out << f.index;
+        for (double ms : f.cpu) out << ',' << ms;
+        for (double ms : f.gpu) {
+            out << ',';
+            if (ms >= 0.0) out << ms;
+        }
+        out << ',' << f.triangles << ',' << f.draws << '\n';
+    }
+    return out.status() == QTextStream::Ok;
+}
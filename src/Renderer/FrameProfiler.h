@@ -0,0 +1,72 @@
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <QOpenGLFunctions_4_1_Core>
+#include <QString>
+#include <chrono>
+#include <cstdint>
+
+/// paintGL 의 pass 별 CPU / GPU 시간 (최근 kHistory 프레임의 min / avg / p99).
+/// GPU 는 GL_TIME_ELAPSED 쿼리를 kLatency 프레임 링으로 돌려 이미 끝난 결과만 읽음 → 파이프라인을 멈추지 않음
+class FrameProfiler {
+public:
+    enum Pass { Upload, Grid, Model, Light, PassCount }; // PassCount 자리는 프레임 전체, Upload 는 pumpUpload
+
+    struct Stats {
+        double min = 0.0, avg = 0.0, p99 = 0.0; // ms
+        size_t samples = 0;
+    };
+
+    static constexpr size_t kHistory = 600;
+    static constexpr size_t kLatency = 3; // 쿼리 결과를 이만큼 뒤 프레임에서 읽음
+
+    void initialize(QOpenGLFunctions_4_1_Core *gl); // 컨텍스트가 current 일 때 (쿼리 객체 생성)
+    void release();
+    void reset(); // 기록된 프레임을 비움 (아직 못 읽은 쿼리 결과는 버려짐)
+
+    void beginFrame();
+    void endFrame();
+    void beginPass(Pass p);
+    void endPass(Pass p);
+    void countDraws(size_t draws, size_t triangles);
+
+    static const char *passName(int pass); // "upload", "grid", "model", "light", "frame"
+
+    Stats cpuStats(int pass) const;
+    Stats gpuStats(int pass) const;
+    size_t lastDraws() const { return lastDraws_; }
+    size_t lastTriangles() const { return lastTriangles_; }
+
+    QString summary() const; // HUD 에 그릴 여러 줄 텍스트
+
+    /// 기록된 프레임을 한 줄씩 (frame, pass 별 cpu/gpu ms, triangles, draws). GPU 값을 못 읽은 칸은 비움
+    bool exportCsv(const QString &path) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Frame {
+        uint64_t index = 0;
+        double cpu[PassCount + 1]{};
+        double gpu[PassCount + 1]{}; // 음수 = 없음
+        uint64_t triangles = 0;
+        uint32_t draws = 0;
+    };
+
+    void collect(size_t slot); // slot 에 걸린 쿼리 중 끝난 것을 해당 프레임 기록에 채움
+
+    template<class Get>
+    Stats stats(Get &&get) const;
+
+    QOpenGLFunctions_4_1_Core *gl_ = nullptr;
+    GLuint queries_[kLatency][PassCount]{};
+    uint64_t queryFrame_[kLatency]{}; // slot 이 어느 프레임 쿼리를 담고 있는지 (0 = 비어 있음)
+    bool issued_[kLatency][PassCount]{};
+
+    Frame history_[kHistory];
+    uint64_t frame_ = 0; // 지금 프레임 번호 (1 부터)
+    Clock::time_point frameStart_, passStart_[PassCount];
+    size_t lastDraws_ = 0, lastTriangles_ = 0;
+};
+
+#endif //FRAMEPROFILER_H
@@ -1,27 +1,90 @@
 #include "GLWidget.h"
+#include <algorithm>
+#include <QElapsedTimer>
 #include <QFileInfo>
+#include <QPainter>
+#include <QThread>
+#include <cstring>
 #include <string>
 
+namespace {
+    /// clip = P·V·M 의 행에서 뽑은 6개 평면 (Gribb–Hartmann). 평면 안쪽이 양수, M 좌표계 기준
+    struct Frustum {
+        QVector4D planes[6];
+
+        explicit Frustum(const QMatrix4x4 &clip) {
+            for (int i = 0; i < 3; ++i) {
+                planes[2 * i] = clip.row(3) + clip.row(i);
+                planes[2 * i + 1] = clip.row(3) - clip.row(i);
+            }
+        }
+
+        /// 평면 법선 쪽으로 가장 먼 꼭짓점마저 바깥이면 상자 전체가 바깥
+        bool intersects(const glm::vec3 &mn, const glm::vec3 &mx) const {
+            for (const QVector4D &p : planes) {
+                float x = p.x() >= 0.0f ? mx.x : mn.x;
+                float y = p.y() >= 0.0f ? mx.y : mn.y;
+                float z = p.z() >= 0.0f ? mx.z : mn.z;
+                if (p.x() * x + p.y() * y + p.z() * z + p.w() < 0.0f) return false;
+            }
+            return true;
+        }
+    };
+
+    /// eye 에서 meshlet 의 모든 삼각형이 뒷면인지 (노멀 콘 + 경계 구, 모델 좌표)
+    bool backFacing(const Meshlet &m, const glm::vec3 &eye) {
+        glm::vec3 d = m.center - eye;
+        return glm::dot(d, m.coneAxis) >= m.coneCutoff * glm::length(d) + m.radius;
+    }
+}
+
 GLWidget::GLWidget(QWidget *parent)
     : QOpenGLWidget(parent) {
     setFocusPolicy(Qt::StrongFocus); // 위젯이 키보드 포커스 받을 수 있도록
+
+    // 상태가 바뀔 때만 그림. timer_ 는 FPS 제한에 걸린 요청을 뒤로 미룰 때만 씀
+    timer_.setSingleShot(true);
     connect(&timer_, &QTimer::timeout, this, QOverload<>::of(&GLWidget::update));
-    timer_.start(16); // ~60 FPS
+    connect(this, &QOpenGLWidget::frameSwapped, this, [this] {
+        if (continuous_) requestFrame();
+    });
+}
+
+GLWidget::~GLWidget() {
+    // 로드 스레드가 this 를 참조하므로 모두 끝날 때까지 기다림
+    if (loadCtl_) loadCtl_->cancel = true;
+    if (lodCancel_) *lodCancel_ = true;
+    if (bvhCancel_) *bvhCancel_ = true;
+    if (restoreCtl_) restoreCtl_->cancel = true;
+    for (QThread *t : findChildren<QThread *>())
+        t->wait();
+
+    if (isValid()) {
+        makeCurrent();
+        profiler_.release();
+        for (GpuMesh &m : meshes_)
+            if (m.retired) glDeleteSync(m.retired);
+        doneCurrent();
+    }
 }
 
 
 void GLWidget::initializeGL() {
     initializeOpenGLFunctions();
+    profiler_.initialize(this);
 
     glEnable(GL_DEPTH_TEST);
 
     loadShaders(phongProg_, ":/shaders/phong.vert", ":/shaders/phong.frag");
     loadShaders(gridProg_, ":/shaders/grid.vert", ":/shaders/grid.frag");
+    loadShaders(gridPlaneProg_, ":/shaders/gridplane.vert", ":/shaders/gridplane.frag");
 
-    QFileInfo fi(base + "/res/models/teddybear.obj");
-    loadModel(fi.absoluteFilePath());
+    createModelBuffers();
     loadCube();
 
+    QFileInfo fi(base + "/res/models/teddybear.obj");
+    openModel(fi.absoluteFilePath());
+
     camDist_ = 3.5f;
     updateCamera();
     updateLight();
@@ -30,6 +93,26 @@ void GLWidget::initializeGL() {
     glClearColor(107 / 255.f, 142 / 255.f, 35 / 255.f, 1.0f);
 }
 
+void GLWidget::initializeOffscreen(const QSize &size) {
+    resize(size); // selectLod 가 height() 를 씀
+    initializeGL();
+    resizeGL(size.width(), size.height());
+}
+
+void GLWidget::waitUntilIdle() {
+    while (isBusy()) {
+        QCoreApplication::processEvents(upload_ ? QEventLoop::AllEvents : QEventLoop::WaitForMoreEvents);
+        if (upload_) renderOnce();
+    }
+}
+
+void GLWidget::cancelBvhBuild() {
+    if (bvhCancel_) *bvhCancel_ = true;
+    bvhCancel_.reset();
+    for (QThread *t : findChildren<QThread *>())
+        t->wait();
+}
+
 void GLWidget::resizeGL(int w, int h) {
     glViewport(0, 0, w, h);
     proj_.setToIdentity();
@@ -37,15 +120,49 @@ void GLWidget::resizeGL(int w, int h) {
 }
 
 void GLWidget::paintGL() {
+    frameClock_.start();
+    profiler_.beginFrame();
+    profiler_.beginPass(FrameProfiler::Upload);
+    pumpUpload(); // 다 올라가면 이 프레임부터 새 버퍼로 그림
+    profiler_.endPass(FrameProfiler::Upload);
+    glEnable(GL_DEPTH_TEST); // HUD 의 QPainter 가 GL 상태를 바꿔 놓으므로 매 프레임 다시
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    profiler_.beginPass(FrameProfiler::Grid);
     drawGrid();
+    profiler_.endPass(FrameProfiler::Grid);
+    profiler_.beginPass(FrameProfiler::Model);
     drawModel();
+    profiler_.endPass(FrameProfiler::Model);
+    profiler_.beginPass(FrameProfiler::Light);
     drawLight();
+    profiler_.endPass(FrameProfiler::Light);
 
+#ifndef NDEBUG
+    // glGetError 는 드라이버와 동기화하므로 디버그 빌드에서만
     GLenum err = glGetError();
     if (err != GL_NO_ERROR)
         qDebug() << "GL ERROR =" << err;
+#endif
+    profiler_.endFrame();
+
+    if (showHud_) drawHud();
+}
+
+void GLWidget::drawHud() {
+    QPainter painter(this);
+    QFont font("Menlo");
+    font.setStyleHint(QFont::Monospace);
+    font.setPointSize(10);
+    painter.setFont(font);
+
+    const QString text = profiler_.summary();
+    const QRect box = painter.fontMetrics().boundingRect(QRect(0, 0, width(), height()),
+                                                         Qt::AlignLeft | Qt::AlignTop, text)
+                          .adjusted(-6, -4, 6, 4).translated(10, 10);
+    painter.fillRect(box, QColor(0, 0, 0, 160));
+    painter.setPen(Qt::white);
+    painter.drawText(box.adjusted(6, 4, -6, -4), Qt::AlignLeft | Qt::AlignTop, text);
 }
 
 void GLWidget::loadShaders(QOpenGLShaderProgram &program, const QString &vert, const QString &frag) {
@@ -54,96 +171,654 @@ void GLWidget::loadShaders(QOpenGLShaderProgram &program, const QString &vert, c
     program.link();
 }
 
-bool GLWidget::loadModel(const QString &path) {
-    if (!model_.load(path.toStdString()))
-        return false;
-
-    if (!vaoModel_) {
-        // ② VAO·VBO·EBO 한 번만 만들기
-        glGenVertexArrays(1, &vaoModel_);
-        glGenBuffers(1, &vboModel_);
-        glGenBuffers(1, &eboModel_);
+void GLWidget::createModelBuffers() {
+    // ② VAO·VBO·EBO 두 벌을 한 번만 만들기 (front / back)
+    for (GpuMesh &m : meshes_) {
+        glGenVertexArrays(1, &m.vao);
+        glGenBuffers(1, &m.vbo);
+        glGenBuffers(1, &m.ebo);
+
+        glBindVertexArray(m.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, m.vbo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m.ebo);
+        setupVertexAttribs();
+        glBindVertexArray(0);
+    }
 
-        glBindVertexArray(vaoModel_);
-        glBindBuffer(GL_ARRAY_BUFFER, vboModel_);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboModel_);
+    // 미리보기용 VAO (VBO 는 첫 배치가 올 때 만듦)
+    glGenVertexArrays(1, &vaoPreview_);
+}
 
-        // attribute 포인터 고정 (위치·노멀·UV)
+void GLWidget::setupVertexAttribs(VertexFormat format) {
+    if (format == VertexFormat::Packed) {
+        // snorm16 위치(w 는 패딩) + 옥타헤드럴 노멀 2개, UV 스트림 없음 (aUV 는 기본값 0)
         glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3,GL_FLOAT,GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, position));
+        glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, sizeof(PackedVertex),
+                              (void *) offsetof(PackedVertex, position));
         glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3,GL_FLOAT,GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, normal));
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2,GL_FLOAT,GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, texcoord));
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex),
+                              (void *) offsetof(PackedVertex, normal));
+        glDisableVertexAttribArray(2);
+        return;
+    }
 
-        glBindVertexArray(0);
+    // attribute 포인터 고정 (위치·노멀·UV)
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3,GL_FLOAT,GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3,GL_FLOAT,GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, normal));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2,GL_FLOAT,GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, texcoord));
+}
+
+void GLWidget::appendPreview(const MeshBatch &batch) {
+    const size_t n = batch.vertices.size();
+    if (n) {
+        makeCurrent();
+        if (previewVerts_ + n > previewCapacity_) {
+            // 두 배로 키운 새 버퍼에 지금까지 올린 부분을 GPU 안에서 복사
+            size_t cap = std::max({previewVerts_ + n, previewCapacity_ * 2, size_t(1) << 16});
+            GLuint buf = 0;
+            glGenBuffers(1, &buf);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buf);
+            glBufferData(GL_COPY_WRITE_BUFFER, cap * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
+            if (previewVerts_) {
+                glBindBuffer(GL_COPY_READ_BUFFER, vboPreview_);
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                                    previewVerts_ * sizeof(Vertex));
+            }
+            glDeleteBuffers(1, &vboPreview_);
+            vboPreview_ = buf;
+            previewCapacity_ = cap;
+            gpuMemory_.preview = cap * sizeof(Vertex);
+            notifyMemory();
+
+            glBindVertexArray(vaoPreview_);
+            glBindBuffer(GL_ARRAY_BUFFER, vboPreview_);
+            setupVertexAttribs();
+            glBindVertexArray(0);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, vboPreview_);
+        glBufferSubData(GL_ARRAY_BUFFER, previewVerts_ * sizeof(Vertex), n * sizeof(Vertex),
+                        batch.vertices.data());
+        previewVerts_ += n;
+        doneCurrent();
     }
 
-    uploadVertexBuffer();
+    // 지금까지 읽은 정점의 bbox 로 화면 맞춤을 계속 갱신
+    glm::vec3 d = batch.bboxMax - batch.bboxMin;
+    setModelMat((batch.bboxMin + batch.bboxMax) * 0.5f, std::max({d.x, d.y, d.z}));
+    requestFrame();
+}
+
+void GLWidget::clearPreview() {
+    if (!vboPreview_) return;
+    makeCurrent();
+    glDeleteBuffers(1, &vboPreview_);
+    doneCurrent();
+    vboPreview_ = 0;
+    previewVerts_ = previewCapacity_ = 0;
+    gpuMemory_.preview = 0;
+    notifyMemory();
+}
 
+void GLWidget::openModel(const QString &path) {
+    // 진행 중인 로드는 취소 (결과는 finishLoad 에서 버려짐), 올리던 이전 모델도 버림
+    if (loadCtl_) loadCtl_->cancel = true;
+    dropModelUpload();
+    clearPreview();
     setModelMat();
 
-    return true;
+    auto ctl = std::make_shared<LoadControl>();
+    auto loaded = std::make_shared<ModelLoader>();
+    loaded->setNormalMode(model_->normalMode());
+    loaded->setOptimizeIndexOrder(optimizeOrder_);
+
+    // 워커 스레드에서 불림 → 퍼센트가 바뀔 때만 GUI 스레드로 넘김
+    auto lastPercent = std::make_shared<std::atomic<int>>(-1);
+    LoadControl *raw = ctl.get();
+    ctl->onBatch = [this, raw](MeshBatch &&b) {
+        auto batch = std::make_shared<MeshBatch>(std::move(b));
+        QMetaObject::invokeMethod(this, [this, raw, batch] {
+            if (loadCtl_.get() == raw) appendPreview(*batch);
+        }, Qt::QueuedConnection);
+    };
+    ctl->onProgress = [this, raw, lastPercent](float f, const char *stage) {
+        int pct = static_cast<int>(f * 100.0f);
+        if (lastPercent->exchange(pct) == pct) return;
+        QString s = QString::fromUtf8(stage);
+        QMetaObject::invokeMethod(this, [this, raw, pct, s] {
+            if (loadCtl_.get() == raw) emit loadProgress(pct, s);
+        }, Qt::QueuedConnection);
+    };
+
+    const std::string file = path.toStdString();
+    QThread *thread = QThread::create([this, loaded, ctl, file, path] {
+        QElapsedTimer t;
+        t.start();
+        bool ok = loaded->load(file, true, ctl.get());
+        qint64 ms = t.elapsed();
+        QMetaObject::invokeMethod(this, [this, loaded, ctl, ok, path, ms] {
+            finishLoad(loaded, ctl, ok, path, ms);
+        }, Qt::QueuedConnection);
+    });
+    thread->setParent(this);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+
+    loadCtl_ = ctl;
+    emit loadStarted(path);
+    thread->start();
 }
 
-void GLWidget::uploadVertexBuffer() {
-    const auto &verts = model_.vertices();
-    const auto &idx = model_.indices();
+void GLWidget::cancelLoad() {
+    const bool uploading = upload_ && upload_->newModel;
+    if (!loadCtl_ && !uploading) return;
+    if (loadCtl_) loadCtl_->cancel = true;
+    loadCtl_.reset();
+    dropModelUpload();
+    clearPreview();
+    setModelMat(); // 미리보기 bbox 대신 기존 모델로 복귀
+    requestFrame();
+    emit loadFinished(false, tr("Loading cancelled"));
+}
 
-    glBindVertexArray(vaoModel_);
+void GLWidget::dropModelUpload() {
+    if (!upload_ || !upload_->newModel) return;
+    upload_.reset();
+    // finishLoad 가 끊은 지금 모델의 LOD 생성 / 정점 형식 변경만 다시 시작 (이미 끝났으면 그대로)
+    if (lodInterrupted_) startLodBuild();
+    else if (uploadedFormat_ != vertexFormat_) startUpload(model_, false);
+    lodInterrupted_ = false;
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, vboModel_);
-    glBufferData(GL_ARRAY_BUFFER,
-                 verts.size() * sizeof(Vertex),
-                 verts.data(),
-                 GL_STATIC_DRAW);
+void GLWidget::finishLoad(std::shared_ptr<ModelLoader> loaded, std::shared_ptr<LoadControl> ctl,
+                          bool ok, const QString &path, qint64 ms) {
+    if (ctl != loadCtl_) return; // 취소됐거나 더 새로운 로드가 시작됨
+    loadCtl_.reset();
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboModel_);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                 idx.size() * sizeof(uint32_t),
-                 idx.data(),
-                 GL_STATIC_DRAW);
+    if (!ok) {
+        clearPreview();
+        setModelMat();
+        requestFrame();
+        emit loadFinished(false, tr("Failed to load %1").arg(path));
+        return;
+    }
+
+    // 지금 모델은 곧 교체되므로 LOD 생성 / 그 업로드 취소 (끝나서 올리기 시작하면 새 모델 업로드를 덮어씀).
+    // 새 모델 업로드가 취소되면 dropModelUpload 가 다시 시작
+    lodInterrupted_ = lodCancel_ || (upload_ && upload_->lods);
+    if (lodCancel_) *lodCancel_ = true;
+    lodCancel_.reset();
+
+    // CPU 배열이 모두 준비된 뒤에만 GPU 업로드. 다 올라갈 때까지는 미리보기 / 이전 모델을 계속 그림
+    const QString message = tr("Loaded %1 — %2 triangles in %3 ms%4")
+            .arg(QFileInfo(path).fileName())
+            .arg(loaded->indexCount() / 3)
+            .arg(ms)
+            .arg(loaded->loadedFromCache() ? tr(" (cache)") : QString());
+    startUpload(std::move(loaded), true, nullptr, message);
+}
+
+void GLWidget::startRestore(std::shared_ptr<ModelLoader> model, bool newModel,
+                            std::shared_ptr<LodChain> lods, const QString &message) {
+    upload_.reset(); // 다 읽은 뒤 같은 인자로 다시 시작. 그동안은 front 로 계속 그림
+
+    auto ctl = std::make_shared<LoadControl>();
+    QThread *thread = QThread::create([this, model, newModel, lods, message, ctl] {
+        QElapsedTimer t;
+        t.start();
+        auto data = std::make_shared<UploadData>();
+        const bool ok = model->reloadUploadData(*data, ctl.get());
+        if (ctl->cancel) return;
+        const qint64 ms = t.elapsed();
+        QMetaObject::invokeMethod(this, [this, model, newModel, lods, message, ctl, data, ok, ms] {
+            if (ctl != restoreCtl_) return; // 그 사이 다른 업로드가 시작됨
+            restoreCtl_.reset();
+            if (!ok) {
+                emit statusMessage(tr("Could not reload mesh data — the model file changed or is gone"));
+                return; // 이전 버퍼를 그대로 씀
+            }
+            model->restoreUploadData(std::move(*data));
+            emit statusMessage(tr("Reloaded mesh data in %1 ms").arg(ms));
+            startUpload(model, newModel, lods, message);
+        }, Qt::QueuedConnection);
+    });
+    thread->setParent(this);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+
+    restoreCtl_ = ctl;
+    emit statusMessage(tr("Reloading mesh data..."));
+    thread->start();
+}
+
+void GLWidget::releaseUploadData() {
+    if (!leanMemory_ || lodCancel_ || upload_ || model_->uploadDataReleased()) return;
+    model_->releaseUploadData();
+    notifyMemory();
+}
+
+void GLWidget::startUpload(std::shared_ptr<ModelLoader> model, bool newModel,
+                           std::shared_ptr<LodChain> lods, const QString &message) {
+    if (restoreCtl_) restoreCtl_->cancel = true; // 이 업로드가 대신함
+    restoreCtl_.reset();
+
+    // front 에 이미 올라가 있는 같은 모델의 구간은 CPU 를 거치지 않고 복사
+    const bool sameModel = !newModel && model == model_;
+    const bool copyVertices = sameModel && uploadedFormat_ == vertexFormat_;
+    if (!copyVertices && model->uploadDataReleased()) {
+        // lean 모드로 해제된 사본은 워커 스레드에서 다시 읽음 (큰 모델은 전체 로드만큼 걸림)
+        startRestore(std::move(model), newModel, std::move(lods), message);
+        return;
+    }
+
+    auto job = std::make_unique<UploadJob>();
+    job->model = model;
+    job->newModel = newModel;
+    job->message = message;
+    job->format = vertexFormat_;
+    job->lods = std::move(lods);
+
+    if (copyVertices) {
+        const size_t stride = job->format == VertexFormat::Packed ? sizeof(PackedVertex) : sizeof(Vertex);
+        job->vertexBytes = model->vertexCount() * stride;
+        job->segments.push_back({false, 0, job->vertexBytes, nullptr});
+    } else if (job->format == VertexFormat::Packed) {
+        job->packed = VertexPacking::pack(model->vertices(), model->center(), model->maxExtent());
+        job->vertexBytes = job->packed.size() * sizeof(PackedVertex);
+        job->segments.push_back({false, 0, job->vertexBytes, job->packed.data()});
+    } else {
+        job->vertexBytes = model->vertices().size() * sizeof(Vertex);
+        job->segments.push_back({false, 0, job->vertexBytes, model->vertices().data()});
+    }
+
+    const size_t indexBytes = model->indexCount() * sizeof(uint32_t);
+    const size_t lodBytes = model->lodIndices().size() * sizeof(uint32_t);
+    if (sameModel) {
+        // 새 LOD 가 오면 기존 LOD 구간은 버리고 원본 인덱스만
+        job->indexBytes = job->lods ? indexBytes : indexBytes + lodBytes;
+        job->segments.push_back({true, 0, job->indexBytes, nullptr});
+    } else {
+        job->segments.push_back({true, 0, indexBytes, model->indices().data()});
+        job->indexBytes = indexBytes;
+        if (lodBytes && !job->lods) {
+            job->segments.push_back({true, indexBytes, lodBytes, model->lodIndices().data()});
+            job->indexBytes += lodBytes;
+        }
+    }
+    if (job->lods && !job->lods->indices.empty()) {
+        const size_t bytes = job->lods->indices.size() * sizeof(uint32_t);
+        job->segments.push_back({true, job->indexBytes, bytes, job->lods->indices.data()});
+        job->indexBytes += bytes;
+    }
+    job->totalBytes = job->vertexBytes + job->indexBytes;
+
+    upload_ = std::move(job);
+    requestFrame();
+}
+
+void GLWidget::reserveStorage(GLuint buffer, size_t &capacity, size_t bytes) {
+    // 맞는 크기면 재할당 없이 덮어씀. 모자라거나 절반도 안 쓰게 되면 새로 할당 (이전 저장소는 드라이버가 orphan)
+    if (bytes <= capacity && bytes * 2 >= capacity) return;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STATIC_DRAW);
+    capacity = bytes;
+}
+
+void GLWidget::pumpUpload() {
+    if (!upload_) return;
+    UploadJob &job = *upload_;
+    GpuMesh &back = meshes_[1 - front_];
+    const GpuMesh &front = meshes_[front_];
+
+    if (!job.started) {
+        // back 으로 그린 마지막 프레임이 GPU 에서 아직 안 끝났으면 기다리지 않고 다음 프레임에 다시
+        if (back.retired) {
+            if (glClientWaitSync(back.retired, 0, 0) == GL_TIMEOUT_EXPIRED) {
+                requestFrame();
+                return;
+            }
+            glDeleteSync(back.retired);
+            back.retired = nullptr;
+        }
+        reserveStorage(back.vbo, back.vboCapacity, job.vertexBytes);
+        reserveStorage(back.ebo, back.eboCapacity, job.indexBytes);
+        updateGpuMemory();
+        job.started = true;
+    }
+
+    // VAO 를 건드리지 않도록 COPY_READ / COPY_WRITE 에 바인딩해서 씀
+    size_t budget = kUploadChunkBytes;
+    while (job.segment < job.segments.size()) {
+        const UploadJob::Segment &seg = job.segments[job.segment];
+        const size_t n = std::min(budget, seg.bytes - job.segmentDone);
+        if (seg.bytes && !n) break; // 이번 프레임 몫을 다 씀
+        const size_t offset = seg.offset + job.segmentDone;
+        glBindBuffer(GL_COPY_WRITE_BUFFER, seg.index ? back.ebo : back.vbo);
+        if (!n) {
+            // 빈 구간
+        } else if (!seg.cpu) {
+            glBindBuffer(GL_COPY_READ_BUFFER, seg.index ? front.ebo : front.vbo);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset),
+                                static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(n));
+        } else {
+            // back 은 GPU 가 읽지 않는 저장소 (위 fence 확인) → 동기화 없이 매핑
+            const char *src = static_cast<const char *>(seg.cpu) + job.segmentDone;
+            void *dst = glMapBufferRange(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset),
+                                         static_cast<GLsizeiptr>(n),
+                                         GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+                                         GL_MAP_UNSYNCHRONIZED_BIT);
+            if (dst) std::memcpy(dst, src, n);
+            // 매핑 실패 / 매핑 중 저장소 손실 (glUnmapBuffer == false) 이면 일반 경로로 다시 씀
+            if (!dst || !glUnmapBuffer(GL_COPY_WRITE_BUFFER))
+                glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset),
+                                static_cast<GLsizeiptr>(n), src);
+        }
+        budget -= n;
+        job.written += n;
+        job.segmentDone += n;
+        if (job.segmentDone == seg.bytes) {
+            ++job.segment;
+            job.segmentDone = 0;
+        }
+    }
 
+    if (job.segment < job.segments.size()) {
+        if (job.newModel)
+            emit loadProgress(static_cast<int>(100 * job.written / std::max<size_t>(job.totalBytes, 1)),
+                              tr("Uploading"));
+        requestFrame(); // 남은 부분은 다음 프레임에 (그동안 front 로 계속 그림)
+        return;
+    }
+    finishUpload();
+}
+
+void GLWidget::finishUpload() {
+    std::unique_ptr<UploadJob> job = std::move(upload_);
+    GpuMesh &back = meshes_[1 - front_];
+
+    // 속성 레이아웃은 형식마다 다름 (EBO 는 VAO 를 만들 때 연결해 둠)
+    glBindVertexArray(back.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, back.vbo);
+    setupVertexAttribs(job->format);
     glBindVertexArray(0);
 
-    qDebug() << "verts =" << model_.vertices().size()
-            << "idx   =" << model_.indices().size();
+    // 지금까지 front 로 그린 명령 뒤의 fence → 다음 업로드가 이 버퍼를 덮어써도 되는지 확인
+    GpuMesh &old = meshes_[front_];
+    if (old.retired) glDeleteSync(old.retired);
+    old.retired = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    front_ = 1 - front_;
+    uploadedFormat_ = job->format;
+    if (job->lods) job->model->setLods(std::move(*job->lods));
+
+    qDebug() << "verts =" << job->model->vertexCount()
+            << "idx   =" << job->model->indexCount()
+            << "lods  =" << job->model->lods().size()
+            << "vbo   =" << job->vertexBytes / (1024.0 * 1024.0) << "MB";
+
+    if (job->newModel) {
+        job->model->setNormalMode(model_->normalMode()); // 로드 / 업로드 중에 바뀌었을 수 있음
+        model_ = job->model;
+        // 미리보기는 새 모델이 보이는 이 프레임에 정리 (paintGL 안이라 컨텍스트는 이미 current)
+        glDeleteBuffers(1, &vboPreview_);
+        vboPreview_ = 0;
+        previewVerts_ = previewCapacity_ = 0;
+        gpuMemory_.preview = 0;
+        lodInterrupted_ = false;
+        startLodBuild();
+        startBvhBuild();
+        setModelMat();
+        emit loadFinished(true, job->message);
+    }
+    releaseUploadData();
+    updateGpuMemory();
+}
+
+void GLWidget::updateGpuMemory() {
+    const GpuMesh &front = meshes_[front_], &back = meshes_[1 - front_];
+    gpuMemory_.vertexBuffer = front.vboCapacity;
+    gpuMemory_.indexBuffer = front.eboCapacity;
+    gpuMemory_.backBuffers = back.vboCapacity + back.eboCapacity;
+    notifyMemory();
+}
+
+void GLWidget::startLodBuild() {
+    if (lodCancel_) *lodCancel_ = true;
+    lodCancel_.reset();
+    // lean 모드는 LOD 가 끝난 뒤에만 해제하므로 해제된 모델은 이미 LOD 가 있음 (빈 인덱스로 만들면 LOD 를 지움)
+    if (model_->indexCount() / 3 < ModelLoader::kLodMinTriangles || model_->uploadDataReleased()) return;
+
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    std::shared_ptr<const ModelLoader> model = model_;
+    QThread *thread = QThread::create([this, model, cancel] {
+        auto lods = std::make_shared<LodChain>(model->buildLods(cancel.get()));
+        if (*cancel) return;
+        QMetaObject::invokeMethod(this, [this, model, cancel, lods] {
+            // 그 사이 다른 모델로 바뀌었으면 버림
+            if (cancel != lodCancel_ || model != model_) return;
+            lodCancel_.reset();
+            startUpload(model_, false, lods); // LOD 메타데이터는 EBO 가 바뀌는 프레임에 같이 바뀜
+        }, Qt::QueuedConnection);
+    });
+    thread->setParent(this);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+
+    lodCancel_ = cancel;
+    thread->start();
+}
+
+void GLWidget::startBvhBuild() {
+    if (bvhCancel_) *bvhCancel_ = true;
+    bvhCancel_.reset();
+    bvh_.reset();
+
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    std::shared_ptr<const ModelLoader> model = model_;
+    QThread *thread = QThread::create([this, model, cancel] {
+        QElapsedTimer t;
+        t.start();
+        auto bvh = std::make_shared<Bvh>();
+        const auto &idx = model->rawIndices();
+        if (!bvh->build(model->rawPositions().data(), idx.data(), idx.size() / 3, cancel.get())) return;
+        const qint64 ms = t.elapsed();
+        QMetaObject::invokeMethod(this, [this, model, cancel, bvh, ms] {
+            if (cancel != bvhCancel_ || model != model_) return;
+            bvhCancel_.reset();
+            bvh_ = bvh;
+            emit statusMessage(tr("BVH ready — %1 nodes, %2 MB in %3 ms")
+                               .arg(bvh->nodeCount())
+                               .arg(bvh->memoryBytes() / (1024.0 * 1024.0), 0, 'f', 1)
+                               .arg(ms));
+            notifyMemory();
+        }, Qt::QueuedConnection);
+    });
+    thread->setParent(this);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+
+    bvhCancel_ = cancel;
+    thread->start();
+}
+
+namespace {
+    QString megabytes(size_t bytes) {
+        return QString::number(bytes / (1024.0 * 1024.0), 'f', 1);
+    }
+}
+
+QString GLWidget::memoryReport() const {
+    QString text = tr("CPU mesh arrays (MB)\n");
+    for (const MemoryEntry &e : model_->memoryUsage())
+        text += QString("  %1 %2\n").arg(QLatin1String(e.name), -15).arg(megabytes(e.bytes), 8);
+    text += QString("  %1 %2\n").arg(QLatin1String("total"), -15).arg(megabytes(model_->memoryBytes()), 8);
+    text += QString("  %1 %2\n").arg(QLatin1String("bvh"), -15).arg(megabytes(bvh_ ? bvh_->memoryBytes() : 0), 8);
+
+    text += tr("GPU buffers (MB)\n");
+    text += QString("  %1 %2\n").arg(QLatin1String("vertex"), -15).arg(megabytes(gpuMemory_.vertexBuffer), 8);
+    text += QString("  %1 %2\n").arg(QLatin1String("index"), -15).arg(megabytes(gpuMemory_.indexBuffer), 8);
+    text += QString("  %1 %2\n").arg(QLatin1String("back (reuse)"), -15).arg(megabytes(gpuMemory_.backBuffers), 8);
+    text += QString("  %1 %2\n").arg(QLatin1String("preview"), -15).arg(megabytes(gpuMemory_.preview), 8);
+
+    // RSS 는 프로세스 전체 (Qt, 드라이버, 다른 로드 스레드 포함)
+    const LoadMemory &lm = model_->loadMemory();
+    text += tr("Last load: parser %1 MB, RSS %2 → %3 MB, peak %4 MB%5")
+            .arg(megabytes(lm.parser), megabytes(lm.rssBefore), megabytes(lm.rssAfter), megabytes(lm.rssPeak),
+                 lm.peakIsLocal ? QString() : tr(" (since process start)"));
+    return text;
+}
+
+GLWidget::MemoryStats GLWidget::memoryStats() const {
+    MemoryStats m;
+    m.triangles = model_->indexCount() / 3;
+    m.vertices = model_->vertexCount();
+    m.lods = model_->lods().size();
+    m.cpuMesh = model_->memoryBytes();
+    m.gpu = gpuMemory_;
+    return m;
+}
+
+void GLWidget::notifyMemory() {
+    const size_t cpu = model_->memoryBytes() + (bvh_ ? bvh_->memoryBytes() : 0);
+    emit memoryChanged(tr("Mesh %1 MB · GPU %2 MB · Peak RSS %3 MB")
+                       .arg(megabytes(cpu), megabytes(gpuMemory_.total()),
+                            megabytes(model_->loadMemory().rssPeak)));
+}
+
+bool GLWidget::pick(const QPoint &pos, PickResult &out) const {
+    if (!bvh_ || bvh_->empty()) return false;
+
+    // 화면 점 → NDC → 모델 좌표의 near / far 점 (QMatrix4x4::map 이 w 로 나눠줌)
+    const float x = 2.0f * pos.x() / width() - 1.0f;
+    const float y = 1.0f - 2.0f * pos.y() / height();
+    const QMatrix4x4 inv = (proj_ * view_ * modelMat_).inverted();
+    const QVector3D n = inv.map(QVector3D(x, y, -1.0f)), f = inv.map(QVector3D(x, y, 1.0f));
+    const glm::vec3 orig(n.x(), n.y(), n.z());
+    const glm::vec3 dir = glm::normalize(glm::vec3(f.x(), f.y(), f.z()) - orig);
+
+    const auto &positions = model_->rawPositions();
+    const auto &indices = model_->rawIndices();
+    Bvh::Hit hit;
+    if (!bvh_->intersect(positions.data(), indices.data(), orig, dir, hit)) return false;
+
+    out.triangle = hit.triangle;
+    out.point = orig + hit.t * dir;
+    out.barycentric = glm::vec3(1.0f - hit.u - hit.v, hit.u, hit.v);
+    const uint32_t *tri = &indices[3 * size_t(hit.triangle)];
+    out.vertex = tri[0];
+    float best = glm::length(positions[tri[0]] - out.point);
+    for (int k = 1; k < 3; ++k) {
+        float d = glm::length(positions[tri[k]] - out.point);
+        if (d < best) {
+            best = d;
+            out.vertex = tri[k];
+        }
+    }
+    const auto &mats = model_->materialIdsPerFace();
+    out.materialId = hit.triangle < mats.size() ? mats[hit.triangle] : -1;
+    const auto &faces = model_->sourceFaces();
+    const auto &verts = model_->sourceVertices();
+    out.objFace = (hit.triangle < faces.size() ? faces[hit.triangle] : hit.triangle) + 1;
+    out.objVertex = (out.vertex < verts.size() ? verts[out.vertex] : out.vertex) + 1;
+    return true;
+}
+
+int GLWidget::selectLod() const {
+    const auto &lods = model_->lods();
+    if (lods.size() < 2) return 0;
+
+    // 모델은 extent_ 로 나눠 원점 주변 단위 상자에 들어가므로, 카메라에서 가장 가까운 점까지 거리는
+    // 대략 camDist_ - (상자 반대각선). 오차 e 의 화면 크기 ≈ e / d · cot(fov/2) · (높이/2)
+    const float dist = std::max(camDist_ - 0.87f, 0.1f);
+    const float pxPerUnit = proj_(1, 1) / dist * 0.5f * height() * devicePixelRatioF();
+    for (int i = static_cast<int>(lods.size()) - 1; i > 0; --i) {
+        if (lods[i].error / extent_ * pxPerUnit < kLodPixelError)
+            return i;
+    }
+    return 0;
 }
 
 void GLWidget::toggleNormalMode() {
-    auto next = (model_.normalMode() == NormalMode::Vertex)
+    auto next = (model_->normalMode() == NormalMode::Vertex)
                     ? NormalMode::Face
                     : NormalMode::Vertex;
-    model_.setNormalMode(next); // CPU 쪽 vertices_/indices_ 재조립
-    uploadVertexBuffer(); // GPU 버퍼 다시 채워주기
-    update(); // repaint
+    model_->setNormalMode(next); // 버퍼는 그대로, 셰이더 uniform 만 바뀜
+    requestFrame(); // repaint
 }
 
 void GLWidget::setNormalMode(NormalMode mode) {
-    if (model_.normalMode() == mode)
+    if (model_->normalMode() == mode)
+        return;
+
+    model_->setNormalMode(mode);
+    requestFrame();
+}
+
+void GLWidget::setVertexFormat(VertexFormat format) {
+    if (vertexFormat_ == format)
         return;
 
-    model_.setNormalMode(mode);
+    vertexFormat_ = format;
+    if (!isValid()) return; // initializeGL 전이면 첫 업로드 때 반영
+    // 올리는 중이면 같은 내용을 새 형식으로 다시 시작 (lean 모드로 다시 읽은 사본은 끝난 뒤 해제)
+    if (upload_) startUpload(upload_->model, upload_->newModel, upload_->lods, upload_->message);
+    else startUpload(model_, false);
+}
+
+void GLWidget::setOptimizeOrder(bool on) {
+    optimizeOrder_ = on;
+}
+
+void GLWidget::setLeanMemory(bool on) {
+    leanMemory_ = on;
+    releaseUploadData(); // 끌 때는 그대로 두고 다음 재업로드 때 다시 읽음
+}
 
-    makeCurrent(); // 컨텍스트 활성
-    uploadVertexBuffer();
-    doneCurrent(); // 컨텍스트 반환
+void GLWidget::requestFrame() {
+    if (timer_.isActive()) return; // 이미 다음 프레임이 예약됨
+    if (fpsCap_ > 0 && frameClock_.isValid()) {
+        const qint64 wait = 1000 / fpsCap_ - frameClock_.elapsed();
+        if (wait > 0) {
+            timer_.start(static_cast<int>(wait));
+            return;
+        }
+    }
+    update(); // 여러 번 불러도 다음 이벤트 루프에서 한 번만 그림
+}
+
+void GLWidget::setContinuousRendering(bool on) {
+    continuous_ = on;
+    if (on) requestFrame();
+}
 
-    update();
+void GLWidget::setFrameRateCap(int fps) {
+    fpsCap_ = std::max(fps, 0);
+}
+
+void GLWidget::setConeCulling(bool on) {
+    coneCulling_ = on;
+    requestFrame();
 }
 
 void GLWidget::setModelMat() {
+    setModelMat(model_->center(), model_->maxExtent());
+}
+
+void GLWidget::setModelMat(const glm::vec3 &center, float extent) {
+    extent_ = std::max(extent, 1e-6f); // 미리보기 첫 배치는 점 하나일 수도 있음
     modelMat_.setToIdentity();
-    float s = 1.0f / model_.maxExtent();
+    float s = 1.0f / extent_;
     modelMat_.scale(s);
-    modelMat_.translate(-QVector3D(model_.center().x, // 원점 이동
-                                   model_.center().y,
-                                   model_.center().z));
+    modelMat_.translate(-QVector3D(center.x, // 원점 이동
+                                   center.y,
+                                   center.z));
 }
 
 void GLWidget::keyPressEvent(QKeyEvent *e) {
     if (e->key() == Qt::Key_N) {
         toggleNormalMode();
+    } else if (e->key() == Qt::Key_H) {
+        showHud_ = !showHud_;
+        requestFrame();
+    } else if (e->key() == Qt::Key_Escape && (loadCtl_ || (upload_ && upload_->newModel))) {
+        cancelLoad();
     } else {
         QOpenGLWidget::keyPressEvent(e); // 다른 키는 기본 처리
     }
@@ -162,13 +837,13 @@ void GLWidget::wheelEvent(QWheelEvent *event) {
 
     updateCamera();
 
-    update(); // paintGL() 재호출
+    requestFrame(); // paintGL() 재호출
     event->accept();
 }
 
 void GLWidget::mousePressEvent(QMouseEvent *e) {
     if (e->button() == Qt::LeftButton)
-        lastMousePos_ = e->pos();
+        lastMousePos_ = pressPos_ = e->pos();
 }
 
 void GLWidget::mouseMoveEvent(QMouseEvent *e) {
@@ -186,7 +861,49 @@ void GLWidget::mouseMoveEvent(QMouseEvent *e) {
     pitch_ = std::clamp(pitch_, -89.f, 89.f);
 
     updateCamera();
-    update(); // repaint
+    requestFrame(); // repaint
+}
+
+void GLWidget::mouseReleaseEvent(QMouseEvent *e) {
+    if (e->button() != Qt::LeftButton || (e->pos() - pressPos_).manhattanLength() > 3) {
+        QOpenGLWidget::mouseReleaseEvent(e);
+        return;
+    }
+    if (previewVerts_) return; // 로드 중에는 model_ 이 화면과 다름
+
+    QElapsedTimer t;
+    t.start();
+    PickResult r;
+    const bool ok = pick(e->pos(), r);
+    const double us = t.nsecsElapsed() / 1000.0;
+
+    if (!bvh_) {
+        emit statusMessage(tr("BVH is still being built"));
+    } else if (!ok) {
+        emit statusMessage(tr("No hit (%1 µs)").arg(us, 0, 'f', 1));
+    } else {
+        const auto &mats = model_->materials();
+        const QString mat = r.materialId >= 0 && r.materialId < static_cast<int>(mats.size())
+                                ? QString::fromStdString(mats[r.materialId].name)
+                                : tr("none");
+        // 번호는 OBJ 파일 기준 (순서 최적화로 바뀐 내부 번호가 아님)
+        emit statusMessage(tr("Face %1 at (%2, %3, %4), bary (%5, %6, %7), vertex %8, material %9 — %10 µs")
+                           .arg(r.objFace)
+                           .arg(r.point.x, 0, 'g', 5).arg(r.point.y, 0, 'g', 5).arg(r.point.z, 0, 'g', 5)
+                           .arg(r.barycentric.x, 0, 'f', 3).arg(r.barycentric.y, 0, 'f', 3)
+                           .arg(r.barycentric.z, 0, 'f', 3)
+                           .arg(r.objVertex)
+                           .arg(mat)
+                           .arg(us, 0, 'f', 1));
+    }
+}
+
+void GLWidget::setCamera(float yaw, float pitch, float dist) {
+    yaw_ = yaw;
+    pitch_ = pitch;
+    camDist_ = dist;
+    updateCamera();
+    requestFrame();
 }
 
 void GLWidget::updateCamera() {
@@ -205,7 +922,7 @@ void GLWidget::updateCamera() {
 // 버튼 토글 위하여
 void GLWidget::setShowGrid(bool on) {
     showGrid_ = on;
-    update();
+    requestFrame();
 }
 
 void GLWidget::loadCube() {
@@ -231,74 +948,140 @@ void GLWidget::loadCube() {
     glVertexAttribPointer(0, 3,GL_FLOAT,GL_FALSE, sizeof(Vertex),
                           (void *) offsetof(Vertex, position));
     glBindVertexArray(0);
+
+    glGenVertexArrays(1, &vaoGridPlane_);
 }
 
 void GLWidget::drawModel() {
     phongProg_.bind();
     phongProg_.setUniformValue("uProj", proj_);
     phongProg_.setUniformValue("uView", view_);
-    phongProg_.setUniformValue("uModel", modelMat_);
     phongProg_.setUniformValue("uViewPos", eye_);
 
     phongProg_.setUniformValue("uLightPos", lightPos_);
     phongProg_.setUniformValue("uKd", kd_);
     phongProg_.setUniformValue("uKs", ks_);
     phongProg_.setUniformValue("uShin", shininess_);
-
-    glBindVertexArray(vaoModel_);
-    glDrawElements(GL_TRIANGLES,
-                   model_.indices().size(),
-                   GL_UNSIGNED_INT, nullptr);
+    phongProg_.setUniformValue("uFlat", model_->normalMode() == NormalMode::Face);
+
+    // Packed 정점은 [-1, 1] 로 양자화된 위치 → center / extent 복원을 모델 행렬 앞에 붙임
+    const bool packed = !previewVerts_ && uploadedFormat_ == VertexFormat::Packed;
+    QMatrix4x4 model = modelMat_;
+    if (packed) {
+        const glm::vec3 &c = model_->center();
+        model.translate(c.x, c.y, c.z);
+        model.scale(VertexPacking::dequantScale(model_->maxExtent()));
+    }
+    phongProg_.setUniformValue("uModel", model);
+    phongProg_.setUniformValue("uOctNormals", packed);
+
+    if (previewVerts_) {
+        // 스트리밍 로드 중: 지금까지 올라온 앞부분만 그림
+        glBindVertexArray(vaoPreview_);
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(previewVerts_));
+        profiler_.countDraws(1, previewVerts_ / 3);
+    } else {
+        glBindVertexArray(meshes_[front_].vao);
+        const int lod = selectLod();
+        if (lod == 0) {
+            // 원본은 클러스터 단위로 컬링 (LOD 는 모델이 화면에 작을 때만 쓰이므로 통째로 그림)
+            drawVisibleClusters();
+        } else {
+            const LodLevel &level = model_->lods()[lod];
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(level.indexCount),
+                           GL_UNSIGNED_INT, (void *) (level.firstIndex * sizeof(uint32_t)));
+            profiler_.countDraws(1, level.indexCount / 3);
+        }
+    }
     glBindVertexArray(0);
     phongProg_.release();
 }
 
-void GLWidget::drawGrid() {
-    if (!showGrid_) return;
-
-    gridProg_.bind();
-    gridProg_.setUniformValue("uColor", QVector4D(1, 1, 1, 1));
-
-    QMatrix4x4 PV = proj_ * view_;
-    const int n = 5000;
-    const float size = model_.maxExtent(); // 모델 크기가 다 다르기 때문에
-    const float len = size * 1000;
-    const float step = len / n;
-    const float thickness = 0.003f;
-
+void GLWidget::drawVisibleClusters() {
+    const auto &clusters = model_->clusters();
+    const auto &meshlets = model_->meshlets();
+    const bool cones = coneCulling_ && !meshlets.empty();
+    if (clusters.empty() && !cones) {
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(model_->indexCount()),
+                       GL_UNSIGNED_INT, nullptr);
+        profiler_.countDraws(1, model_->indexCount() / 3);
+        return;
+    }
 
-    glBindVertexArray(vaoGrid_);
-    for (int j = 0; j <= n; ++j) {
-        float z = -len / 2 + step * j;
-        QMatrix4x4 M;
+    // 클러스터 bbox / meshlet 콘은 원래 모델 좌표 → packed 보정 전의 modelMat_ 기준으로 검사
+    const Frustum frustum(proj_ * view_ * modelMat_);
+    const QVector3D eyeModel = modelMat_.inverted().map(eye_);
+    const glm::vec3 eye(eyeModel.x(), eyeModel.y(), eyeModel.z());
+
+    drawCounts_.clear();
+    drawOffsets_.clear();
+    size_t runFirst = 0, runEnd = 0; // 이어지는 보이는 구간은 draw 하나로 합침
+    size_t visibleIndices = 0;
+    auto flush = [&] {
+        if (runEnd > runFirst) {
+            visibleIndices += runEnd - runFirst;
+            drawCounts_.push_back(static_cast<GLsizei>(runEnd - runFirst));
+            drawOffsets_.push_back((const void *) (runFirst * sizeof(uint32_t)));
+        }
+    };
+    auto addRange = [&](size_t first, size_t count) {
+        if (runEnd != first) {
+            flush();
+            runFirst = first;
+        }
+        runEnd = first + count;
+    };
+    auto addMeshlets = [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i)
+            if (!backFacing(meshlets[i], eye)) addRange(meshlets[i].firstIndex, meshlets[i].indexCount);
+    };
+
+    if (clusters.empty()) {
+        addMeshlets(0, meshlets.size());
+    } else {
+        for (const MeshCluster &c : clusters) {
+            if (!frustum.intersects(c.bboxMin, c.bboxMax)) continue;
+            if (cones) addMeshlets(c.firstMeshlet, size_t(c.firstMeshlet) + c.meshletCount);
+            else addRange(c.firstIndex, c.indexCount);
+        }
+    }
+    flush();
+    if (drawCounts_.empty()) return;
 
-        //M.translate(QVector3D(-gridCube_.center().x, -gridCube_.center().y, -gridCube_.center().z));
-        //M.translate(0, -0.05f * size, z);
+    glMultiDrawElements(GL_TRIANGLES, drawCounts_.data(), GL_UNSIGNED_INT, drawOffsets_.data(),
+                        static_cast<GLsizei>(drawCounts_.size()));
+    profiler_.countDraws(drawCounts_.size(), visibleIndices / 3);
+}
 
-        M.translate(-len / 2.f, -0.05f * size, z);
-        M.scale(len, thickness * size, thickness * size);
+void GLWidget::drawGrid() {
+    if (!showGrid_) return;
 
-        gridProg_.setUniformValue("uMVP", PV * M);
-        glDrawElements(GL_TRIANGLES, cube_.indices().size(),
-                       GL_UNSIGNED_INT, nullptr);
-    }
-    for (int j = 0; j <= n; ++j) {
-        float x = -len / 2 + j * step;
-        QMatrix4x4 M;
-
-        M.translate(x, -0.05f * size, -len / 2.f);
-        M.scale(thickness * size, thickness * size, len);
-        gridProg_.setUniformValue("uMVP", PV * M);
-        glDrawElements(GL_TRIANGLES, cube_.indices().size(),
-                       GL_UNSIGNED_INT, nullptr);
-    }
+    // 예전 큐브 격자와 같은 배치: 간격 size / 5, 굵기 0.003 size, 한 변 1000 size, 높이 -0.05 size
+    const float size = extent_; // 모델 크기가 다 다르기 때문에
+
+    gridPlaneProg_.bind();
+    gridPlaneProg_.setUniformValue("uPV", proj_ * view_);
+    gridPlaneProg_.setUniformValue("uHalfSize", size * 500.0f);
+    gridPlaneProg_.setUniformValue("uHeight", -0.05f * size);
+    gridPlaneProg_.setUniformValue("uStep", size * 0.2f);
+    gridPlaneProg_.setUniformValue("uLineWidth", 0.003f * size);
+    gridPlaneProg_.setUniformValue("uEye", eye_);
+    gridPlaneProg_.setUniformValue("uFadeDist", 100.0f); // far plane
+    gridPlaneProg_.setUniformValue("uColor", QVector4D(1, 1, 1, 1));
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBindVertexArray(vaoGridPlane_);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    profiler_.countDraws(1, 2);
     glBindVertexArray(0);
-    gridProg_.release();
+    glDisable(GL_BLEND);
+    gridPlaneProg_.release();
 }
 
 void GLWidget::drawLight() {
     // 모델 크기에 맞춰서 빛 크기 조절
-    float s = model_.maxExtent() * 0.005f;
+    float s = extent_ * 0.005f;
 
     QMatrix4x4 M;
 
@@ -316,6 +1099,7 @@ void GLWidget::drawLight() {
     glDrawElements(GL_TRIANGLES,
                    cube_.indices().size(),
                    GL_UNSIGNED_INT, nullptr);
+    profiler_.countDraws(1, cube_.indices().size() / 3);
     glBindVertexArray(0);
     gridProg_.release();
 }
@@ -344,21 +1128,21 @@ void GLWidget::updateLight() {
                   cos(rp) * sin(ry));
 
     lightPos_ = target_ + dir.normalized() * lightRadius_;
-    update();
+    requestFrame();
 }
 
 
 void GLWidget::setKd(int v) {
     kd_ = v / 100.0f;
-    update();
+    requestFrame();
 }
 
 void GLWidget::setKs(int v) {
     ks_ = v / 100.0f;
-    update();
+    requestFrame();
 }
 
 void GLWidget::setShininess(int v) {
     shininess_ = float(v);
-    update();
+    requestFrame();
 }
@@ -2,29 +2,121 @@
 #define GLWIDGET_H
 
 #include <QOpenGLWidget>
-#include <QOpenGLFunctions>
+#include <QOpenGLFunctions_4_1_Core>
 #include <QOpenGLShaderProgram>
 #include <QMatrix4x4>
+#include <QElapsedTimer>
 #include <QTimer>
 #include <QKeyEvent>
+#include <memory>
 
+#include "FrameProfiler.h"
+#include "../core/Bvh.h"
 #include "../core/ModelLoader.h"
+#include "../core/VertexFormat.h"
 
-class GLWidget : public QOpenGLWidget, protected QOpenGLFunctions {
+class GLWidget : public QOpenGLWidget, protected QOpenGLFunctions_4_1_Core {
     Q_OBJECT
 
 public:
     explicit GLWidget(QWidget *parent = nullptr);
 
-    ~GLWidget() override = default;
+    ~GLWidget() override;
+
+    /// 화면 좌표 한 점으로 쏜 레이가 처음 맞는 삼각형 (모델 좌표)
+    struct PickResult {
+        uint32_t triangle = 0;   // rawIndices 의 삼각형 번호 (순서 최적화 뒤의 내부 번호)
+        glm::vec3 point{};
+        glm::vec3 barycentric{}; // 세 꼭짓점 가중치 (합 1)
+        uint32_t vertex = 0;     // point 에 가장 가까운 꼭짓점 (rawPositions 번호, 내부 번호)
+        int materialId = -1;
+        uint32_t objFace = 0;    // 파일 기준: 몇 번째 f 문인지 (1 부터)
+        uint32_t objVertex = 0;  // 파일 기준: vertex 의 v 번호 (1 부터, f 문이 참조하는 번호와 같음)
+    };
+
+    /// BVH 가 아직 없거나 아무것도 안 맞으면 false
+    bool pick(const QPoint &pos, PickResult &out) const;
+
+    /// 지금 GPU 버퍼에 올라가 있는 바이트 (할당 크기 기준)
+    struct GpuMemory {
+        size_t vertexBuffer = 0; // 그리고 있는 모델 VBO
+        size_t indexBuffer = 0;  // 그리고 있는 모델 EBO (원본 + LOD)
+        size_t backBuffers = 0;  // 올리는 중이거나 교체돼 내려온 VBO + EBO (다음 업로드가 재사용)
+        size_t preview = 0;      // 스트리밍 미리보기 VBO
+        size_t total() const { return vertexBuffer + indexBuffer + backBuffers + preview; }
+    };
+
+    const GpuMemory &gpuMemory() const { return gpuMemory_; }
+
+    /// 모델의 CPU 배열별 / GPU 버퍼 / BVH 메모리와 마지막 로드의 RSS (여러 줄 텍스트)
+    QString memoryReport() const;
+
+    /// 최근 프레임들의 pass 별 CPU / GPU 시간을 CSV 로
+    bool exportFrameTimings(const QString &path) const { return profiler_.exportCsv(path); }
+
+    /// 지금 그리는 모델의 크기와 CPU / GPU 메모리 (memoryReport 의 숫자)
+    struct MemoryStats {
+        size_t triangles = 0, vertices = 0, lods = 0;
+        size_t cpuMesh = 0; // ModelLoader::memoryBytes
+        GpuMemory gpu;
+    };
+
+    MemoryStats memoryStats() const;
+
+    const FrameProfiler &profiler() const { return profiler_; }
+
+    void resetProfiler() { profiler_.reset(); } // 지금까지의 프레임 기록을 버림 (쿼리 객체는 그대로)
+
+    /// 로드 / CPU 사본 복원 / GPU 업로드 / LOD 생성 중 하나라도 진행 중 (피킹용 BVH 는 제외)
+    bool isBusy() const { return loadCtl_ || lodCancel_ || restoreCtl_ || upload_; }
+
+    void setCamera(float yaw, float pitch, float dist); // 궤도 카메라 (deg, deg, 타깃까지 거리)
+
+    // 창 없이 쓸 때 (RenderBench): 위젯을 띄우지 않으면 makeCurrent 가 아무 일도 안 하므로
+    // 아래 GL 호출은 모두 호출한 쪽이 current 로 둔 컨텍스트와 FBO 로 감
+
+    void initializeOffscreen(const QSize &size); // initializeGL + resizeGL (renderOnce 전에 한 번)
+
+    void renderOnce() { paintGL(); } // 한 프레임 (진행 중인 업로드도 한 조각 진행)
+
+    void waitUntilIdle(); // isBusy 가 풀릴 때까지 이벤트를 돌림 (업로드는 그릴 때만 진행되므로 그사이 renderOnce)
+
+    void cancelBvhBuild(); // 진행 중인 BVH 생성을 취소하고 워커 스레드가 모두 끝날 때까지 기다림
+
+signals:
+    void loadStarted(const QString &path);
+
+    void loadProgress(int percent, const QString &stage);
+
+    void loadFinished(bool ok, const QString &message);
+
+    void statusMessage(const QString &message); // BVH 생성 시간, 피킹 결과 등
+
+    void memoryChanged(const QString &summary); // 모델 / GPU 버퍼가 바뀔 때 한 줄 요약 (자세한 건 memoryReport)
 
 public slots:
+    void openModel(const QString &path); // 백그라운드 스레드에서 로드
+
+    void cancelLoad();
+
     void toggleNormalMode();
 
     void setNormalMode(NormalMode mode);
 
+    void setVertexFormat(VertexFormat format); // 모델 VBO 레이아웃 (바뀌면 다시 업로드)
+
     void setShowGrid(bool on);
 
+    void setContinuousRendering(bool on); // 벤치마크용: 변화가 없어도 매 프레임 다시 그림
+
+    void setFrameRateCap(int fps); // 0 이면 제한 없음 (continuous 모드와 잦은 입력 모두에 적용)
+
+    void setConeCulling(bool on); // 뒷면만 향한 meshlet 을 그리기 전에 버림 (열린 메쉬는 뒷면이 안 보이게 됨)
+
+    void setOptimizeOrder(bool on); // 다음에 여는 모델부터 삼각형 순서를 정점 캐시에 맞게 재배치 (로드가 느려짐)
+
+    void setLeanMemory(bool on); // GPU 업로드 뒤 모델의 CPU 사본을 해제 (재업로드가 필요하면 캐시에서 다시 읽음)
+
     void setLightYaw(int deg);       // 0-360
     void setLightPitch(int deg);     // -89~89
     void setLightRadius(double r);   // 거리
@@ -47,41 +139,148 @@ protected:
 
     void mouseMoveEvent(QMouseEvent *e) override;
 
+    void mouseReleaseEvent(QMouseEvent *e) override; // 드래그 없이 뗀 클릭은 피킹
+
 private:
-    bool loadModel(const QString &path);
+    void createModelBuffers();
+
+    void setupVertexAttribs(VertexFormat format = VertexFormat::Float32); // 바인딩된 VAO/VBO 에 레이아웃 지정
+
+    void appendPreview(const MeshBatch &batch); // 스트리밍 로드 중 도착한 삼각형을 이어 붙임
+
+    void clearPreview();
+
+    void finishLoad(std::shared_ptr<ModelLoader> loaded, std::shared_ptr<LoadControl> ctl,
+                    bool ok, const QString &path, qint64 ms);
 
     void loadCube();
 
     void loadShaders(QOpenGLShaderProgram& program ,const QString &vert, const QString &frag);
 
-    void uploadVertexBuffer();
+    /// lean 모드로 해제된 model 의 CPU 사본을 워커 스레드에서 다시 읽고, 끝나면 같은 인자로 startUpload.
+    /// 실패하면 상태바에 알리고 이전 버퍼를 그대로 씀
+    void startRestore(std::shared_ptr<ModelLoader> model, bool newModel,
+                      std::shared_ptr<LodChain> lods, const QString &message);
+
+    void releaseUploadData(); // lean 모드이고 LOD 생성 / 업로드가 끝났으면 model_ 의 CPU 사본 해제
+
+    /// model 을 vertexFormat_ 으로 back 버퍼에 올리기 시작 (진행 중인 업로드 / 복원은 버림).
+    /// CPU 사본이 lean 모드로 해제돼 있으면 startRestore 를 먼저 거침.
+    /// lods 가 있으면 원본 인덱스 뒤에 이어서 올리고 끝날 때 model 에 넣음.
+    /// model_ 에서 바뀌지 않은 구간 (같은 형식의 정점, 원본 인덱스) 은 front 버퍼에서 GPU 안에서 복사
+    void startUpload(std::shared_ptr<ModelLoader> model, bool newModel,
+                     std::shared_ptr<LodChain> lods = nullptr, const QString &message = QString());
+
+    void pumpUpload(); // paintGL 시작에서: back 에 최대 kUploadChunkBytes 를 쓰고, 다 올라갔으면 front 와 교체
+
+    void finishUpload(); // back ↔ front 교체와 함께 모델 / LOD / 정점 형식도 바꿈
+
+    void reserveStorage(GLuint buffer, size_t &capacity, size_t bytes); // 맞으면 재사용, 아니면 새로 할당
+
+    void updateGpuMemory();
+
+    void startLodBuild(); // 워커 스레드에서 model_ 의 LOD 체인 생성
+
+    void dropModelUpload(); // 올리던 새 모델을 버리고 finishLoad 가 끊은 model_ 의 작업을 다시 시작
+
+    void startBvhBuild(); // 워커 스레드에서 model_ 의 피킹용 BVH 생성
+
+    int selectLod() const; // 화면상 오차가 kLodPixelError 미만인 가장 거친 LOD
+
+    void drawVisibleClusters(); // 원본 LOD 를 프러스텀 안의 클러스터 / 앞면 meshlet 만 골라 한 번에 그림
+
+    void requestFrame(); // 상태가 바뀌면 update() 대신 호출 (FPS 제한을 넘으면 남은 시간만큼 미룸)
 
     void setModelMat();
 
+    void setModelMat(const glm::vec3 &center, float extent);
+
     void updateCamera();
 
-    void drawGrid();
+    void drawGrid(); // 바닥 평면 하나를 그리고 격자선·거리 페이드는 fragment 셰이더에서
 
     void drawModel();
 
     void drawLight();
 
+    void drawHud(); // 프레임 통계 오버레이 (H 로 토글)
+
     void updateLight();
 
-    QTimer timer_;
+    void notifyMemory(); // memoryChanged 발신
+
+    QTimer timer_;              // FPS 제한으로 미룬 프레임 (single shot)
+    QElapsedTimer frameClock_;  // 마지막 paintGL 시작 시각
+    int fpsCap_ = 0;
+    bool continuous_ = false;
+    FrameProfiler profiler_;
+    bool showHud_ = false;
     QString base = QCoreApplication::applicationDirPath(); // 항상 실행파일이 있는 폴더를 반환
 
     //Shader
     QOpenGLShaderProgram phongProg_;
-    QOpenGLShaderProgram gridProg_;
-
-    // Model
-    ModelLoader model_;
-    GLuint vaoModel_ = 0, vboModel_ = 0, eboModel_ = 0;
+    QOpenGLShaderProgram gridProg_;     // 단색 (조명 위치 큐브)
+    QOpenGLShaderProgram gridPlaneProg_; // 바닥 격자 (셰이더에서 선을 그림)
+
+    // Model (로드가 끝난 모델로 통째로 교체됨)
+    std::shared_ptr<ModelLoader> model_ = std::make_shared<ModelLoader>();
+    std::shared_ptr<LoadControl> loadCtl_; // 진행 중인 로드 (없으면 nullptr)
+    std::shared_ptr<std::atomic<bool>> lodCancel_; // 진행 중인 LOD 생성 (모델이 바뀌면 취소)
+    bool lodInterrupted_ = false;                   // finishLoad 가 model_ 의 LOD 생성 / 업로드를 끊었음
+    static constexpr float kLodPixelError = 1.0f;  // 이 픽셀 오차 안쪽이면 더 거친 LOD 사용
+    std::shared_ptr<const Bvh> bvh_;                // model_ 의 rawPositions / rawIndices 위 BVH (생성 전엔 nullptr)
+    std::shared_ptr<std::atomic<bool>> bvhCancel_;
+
+    /// 모델 VAO / VBO / EBO 한 벌. front 로 그리는 동안 back 에 다음 데이터를 여러 프레임에 걸쳐 올림
+    struct GpuMesh {
+        GLuint vao = 0, vbo = 0, ebo = 0;
+        size_t vboCapacity = 0, eboCapacity = 0; // 할당된 크기
+        GLsync retired = nullptr;                // front 에서 내려온 시점의 fence (GPU 가 지나기 전엔 덮어쓰지 않음)
+    };
+    GpuMesh meshes_[2];
+    int front_ = 0;
+
+    struct UploadJob {
+        /// 대상 버퍼의 한 구간. cpu 가 nullptr 이면 front 버퍼의 같은 구간을 GPU 안에서 복사
+        struct Segment {
+            bool index = false; // false = VBO, true = EBO
+            size_t offset = 0;
+            size_t bytes = 0;
+            const void *cpu = nullptr;
+        };
+
+        std::shared_ptr<ModelLoader> model;
+        bool newModel = false;           // 끝나면 model_ 교체 + LOD / BVH 생성 + loadFinished(message)
+        QString message;
+        VertexFormat format = VertexFormat::Float32;
+        std::shared_ptr<LodChain> lods;  // 끝나면 model->setLods (EBO 의 LOD 구간과 같이 바뀜)
+        std::vector<PackedVertex> packed; // Packed 형식일 때 CPU 원본
+        std::vector<Segment> segments;
+        size_t vertexBytes = 0, indexBytes = 0, totalBytes = 0;
+        size_t segment = 0, segmentDone = 0, written = 0;
+        bool started = false;            // back 저장소 준비 (fence 확인 + 재사용 / 할당) 완료
+    };
+    std::unique_ptr<UploadJob> upload_;
+    std::shared_ptr<LoadControl> restoreCtl_; // startRestore 진행 중 (새 업로드가 시작되면 취소)
+    static constexpr size_t kUploadChunkBytes = size_t(32) << 20; // 프레임당 최대 업로드 / 복사량
+    float extent_ = 1.0f; // 지금 그리고 있는 모델(또는 미리보기)의 크기
+    VertexFormat vertexFormat_ = VertexFormat::Float32;
+    VertexFormat uploadedFormat_ = VertexFormat::Float32; // 지금 front VBO 에 들어 있는 레이아웃
+    std::vector<GLsizei> drawCounts_;       // glMultiDrawElements 인자 (프레임마다 재사용)
+    std::vector<const void *> drawOffsets_;
+    bool coneCulling_ = false; // 기본은 원래처럼 모든 면을 그림 (열린 메쉬의 구멍 너머가 사라지지 않게)
+    bool leanMemory_ = false;
+    bool optimizeOrder_ = false;
+    GpuMemory gpuMemory_;
+
+    // 스트리밍 미리보기 (triangle soup, 용량은 두 배씩 늘림)
+    GLuint vaoPreview_ = 0, vboPreview_ = 0;
+    size_t previewVerts_ = 0, previewCapacity_ = 0;
 
     // Grid Cube
     ModelLoader cube_;
     GLuint vaoGrid_ = 0, vboGrid_ = 0, eboGrid_ = 0;
+    GLuint vaoGridPlane_ = 0; // 속성 없는 빈 VAO (core profile 은 draw 에 VAO 가 필요)
     bool showGrid_ = true;
 
     QMatrix4x4 proj_, view_, modelMat_;
@@ -94,6 +293,7 @@ private:
     float pitch_ = -45.0f;
 
     QPoint lastMousePos_;
+    QPoint pressPos_; // 클릭인지 드래그인지 구분
 
     //Lighting parameters
     float lightYaw_    = 45.0f;   // 도(deg)  0 = +X,  90 = +Z
@@ -0,0 +1,252 @@
+#include "RenderBench.h"
+#include "GLWidget.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+    void fail(const QString &msg) {
+        std::fprintf(stderr, "obj_viewer --bench-render: %s\n", qPrintable(msg));
+    }
+
+    void usage() {
+        std::fprintf(stderr,
+            "usage: obj_viewer --bench-render [options] [model.obj]\n"
+            "  --frames N          measured frames (default 600)\n"
+            "  --warmup N          frames rendered before measuring (default 30)\n"
+            "  --size WxH          framebuffer size (default 1280x720)\n"
+            "  --packed            upload the model as packed vertices\n"
+            "  --cone-culling      skip back-facing meshlets (closed meshes only)\n"
+            "  --lean              free the CPU mesh copies after upload\n"
+            "  --json out.json     write the report to a file instead of stdout\n"
+            "  --image out.png     save the last frame\n");
+    }
+
+    /// i / n 위치의 카메라 (deg, deg, 거리). 한 바퀴 도는 동안 높이는 두 번, 거리는 한 번 오르내림
+    /// → 클러스터 컬링, 뒷면 meshlet 컬링, LOD 선택이 모두 프레임마다 바뀜
+    void orbit(int i, int n, float &yaw, float &pitch, float &dist) {
+        constexpr double kTwoPi = 6.283185307179586;
+        const double t = double(i) / std::max(n, 1);
+        yaw = static_cast<float>(45.0 + 360.0 * t);
+        pitch = static_cast<float>(-30.0 + 20.0 * std::sin(2.0 * kTwoPi * t));
+        dist = static_cast<float>(3.5 * (1.0 + 0.6 * std::sin(kTwoPi * t))); // 1.4 ~ 5.6
+    }
+
+    /// 정렬된 값의 nearest-rank 백분위
+    double percentile(const std::vector<double> &sorted, double q) {
+        const size_t rank = static_cast<size_t>(std::ceil(q * sorted.size()));
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    }
+
+    QJsonObject summarize(std::vector<double> v) {
+        std::sort(v.begin(), v.end());
+        double sum = 0.0;
+        for (double x : v) sum += x;
+        return {
+            {"min", v.front()}, {"p50", percentile(v, 0.50)}, {"p90", percentile(v, 0.90)},
+            {"p95", percentile(v, 0.95)}, {"p99", percentile(v, 0.99)}, {"max", v.back()},
+            {"mean", sum / v.size()},
+        };
+    }
+
+    QJsonObject range(const std::vector<double> &v) {
+        double sum = 0.0;
+        for (double x : v) sum += x;
+        return {
+            {"min", *std::min_element(v.begin(), v.end())},
+            {"mean", sum / v.size()},
+            {"max", *std::max_element(v.begin(), v.end())},
+        };
+    }
+
+    QJsonObject stats(const FrameProfiler::Stats &s) {
+        if (!s.samples) return {{"samples", 0}};
+        return {{"min", s.min}, {"avg", s.avg}, {"p99", s.p99}, {"samples", static_cast<qint64>(s.samples)}};
+    }
+}
+
+int RenderBench::run(const QStringList &args) {
+    Options opt;
+    if (!parseArgs(args, opt)) return 2;
+    return run(opt);
+}
+
+bool RenderBench::parseArgs(const QStringList &args, Options &opt) {
+    for (int i = 1; i < args.size(); ++i) {
+        const QString &a = args[i];
+        auto next = [&]() -> QString {
+            if (i + 1 >= args.size()) {
+                fail(a + " needs a value");
+                return {};
+            }
+            return args[++i];
+        };
+        bool ok = true;
+        if (a == "--bench-render") continue;
+        if (a == "--frames") opt.frames = next().toInt(&ok);
+        else if (a == "--warmup") opt.warmup = next().toInt(&ok);
+        else if (a == "--size") {
+            const QStringList wh = next().split('x');
+            bool okH = false;
+            if (wh.size() == 2) opt.size = QSize(wh[0].toInt(&ok), wh[1].toInt(&okH));
+            ok = ok && okH && !opt.size.isEmpty();
+        }
+        else if (a == "--packed") opt.packed = true;
+        else if (a == "--cone-culling") opt.coneCulling = true;
+        else if (a == "--lean") opt.lean = true;
+        else if (a == "--json") ok = !(opt.jsonPath = next()).isEmpty();
+        else if (a == "--image") ok = !(opt.imagePath = next()).isEmpty();
+        else if (a == "-h" || a == "--help") ok = false;
+        else if (a.startsWith('-')) ok = false;
+        else opt.model = a;
+
+        if (!ok || opt.frames < 1 || opt.warmup < 0) {
+            usage();
+            return false;
+        }
+    }
+    if (opt.model.isEmpty())
+        opt.model = QCoreApplication::applicationDirPath() + "/res/models/teddybear.obj";
+    return true;
+}
+
+int RenderBench::run(const Options &opt) {
+    // 컨텍스트를 위젯보다 먼저 만들어 위젯의 GL 객체가 지워질 때까지 current 로 유지
+    QOffscreenSurface surface;
+    surface.setFormat(QSurfaceFormat::defaultFormat());
+    surface.create();
+    QOpenGLContext context;
+    context.setFormat(QSurfaceFormat::defaultFormat());
+    if (!context.create() || !context.makeCurrent(&surface)) {
+        fail("cannot create an OpenGL context (try QT_QPA_PLATFORM=offscreen, xvfb-run or LIBGL_ALWAYS_SOFTWARE=1)");
+        return 1;
+    }
+    QOpenGLFunctions *f = context.functions();
+    const QString renderer = QString::fromLatin1(reinterpret_cast<const char *>(f->glGetString(GL_RENDERER)));
+    const QString version = QString::fromLatin1(reinterpret_cast<const char *>(f->glGetString(GL_VERSION)));
+
+    QOpenGLFramebufferObjectFormat fboFormat;
+    fboFormat.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+    QOpenGLFramebufferObject fbo(opt.size, fboFormat);
+    if (!fbo.isValid() || !fbo.bind()) {
+        fail("cannot create a framebuffer object");
+        return 1;
+    }
+
+    // 화면에 띄우지 않은 QOpenGLWidget 은 makeCurrent / doneCurrent 가 아무 일도 안 하므로
+    // 위젯 코드의 GL 호출은 모두 위 컨텍스트와 FBO 로 감
+    GLWidget w;
+    w.setVertexFormat(opt.packed ? VertexFormat::Packed : VertexFormat::Float32);
+    w.setConeCulling(opt.coneCulling);
+    w.setLeanMemory(opt.lean);
+    w.initializeOffscreen(opt.size);
+
+    bool loaded = false;
+    QString loadMessage;
+    QObject::connect(&w, &GLWidget::loadFinished, [&](bool ok, const QString &msg) {
+        loaded = ok;
+        loadMessage = msg;
+    });
+    w.openModel(QFileInfo(opt.model).absoluteFilePath());
+
+    // 로드, 업로드, LOD 생성과 그 업로드가 끝날 때까지. 피킹용 BVH 는 필요 없으니 취소
+    w.waitUntilIdle();
+    w.cancelBvhBuild();
+    QCoreApplication::processEvents();
+    if (!loaded) {
+        fail(loadMessage.isEmpty() ? QStringLiteral("cannot load %1").arg(opt.model) : loadMessage);
+        return 1;
+    }
+    std::fprintf(stderr, "%s\n", qPrintable(loadMessage));
+
+    auto renderFrame = [&](int i, int n) {
+        float yaw, pitch, dist;
+        orbit(i, n, yaw, pitch, dist);
+        w.setCamera(yaw, pitch, dist);
+        w.renderOnce();
+    };
+
+    for (int i = 0; i < opt.warmup; ++i) renderFrame(i, opt.warmup);
+    f->glFinish();
+    w.resetProfiler(); // 워밍업 프레임이 통계에 섞이지 않게
+
+    // 프레임마다 glFinish 까지 기다림 → 스왑 없는 환경에서의 프레임 지연 (CPU 기록 + GPU 실행)
+    std::vector<double> frameMs, draws, triangles;
+    frameMs.reserve(opt.frames);
+    draws.reserve(opt.frames);
+    triangles.reserve(opt.frames);
+    QElapsedTimer timer;
+    for (int i = 0; i < opt.frames; ++i) {
+        timer.start();
+        renderFrame(i, opt.frames);
+        f->glFinish();
+        frameMs.push_back(timer.nsecsElapsed() / 1e6);
+        draws.push_back(static_cast<double>(w.profiler().lastDraws()));
+        triangles.push_back(static_cast<double>(w.profiler().lastTriangles()));
+    }
+
+    if (!opt.imagePath.isEmpty() && !fbo.toImage().save(opt.imagePath))
+        fail("cannot write " + opt.imagePath);
+
+    QJsonObject passes;
+    for (int p = 0; p <= FrameProfiler::PassCount; ++p) {
+        passes[QLatin1String(FrameProfiler::passName(p))] = QJsonObject{
+            {"cpu_ms", stats(w.profiler().cpuStats(p))},
+            {"gpu_ms", stats(w.profiler().gpuStats(p))},
+        };
+    }
+    const QJsonObject frame = summarize(frameMs);
+    const GLWidget::MemoryStats mem = w.memoryStats();
+    const QJsonObject report{
+        {"model", QFileInfo(opt.model).absoluteFilePath()},
+        {"model_triangles", static_cast<qint64>(mem.triangles)},
+        {"model_vertices", static_cast<qint64>(mem.vertices)},
+        {"lods", static_cast<qint64>(mem.lods)},
+        {"cpu_mesh_bytes", static_cast<qint64>(mem.cpuMesh)},
+        {"gpu_buffer_bytes", QJsonObject{
+            {"vertex", static_cast<qint64>(mem.gpu.vertexBuffer)},
+            {"index", static_cast<qint64>(mem.gpu.indexBuffer)},
+            {"back", static_cast<qint64>(mem.gpu.backBuffers)},
+            {"total", static_cast<qint64>(mem.gpu.total())},
+        }},
+        {"gl_renderer", renderer},
+        {"gl_version", version},
+        {"width", opt.size.width()},
+        {"height", opt.size.height()},
+        {"vertex_format", opt.packed ? "packed" : "float32"},
+        {"cone_culling", opt.coneCulling},
+        {"lean", opt.lean},
+        {"warmup", opt.warmup},
+        {"frames", opt.frames},
+        {"frame_ms", frame},
+        {"fps", 1000.0 / frame["mean"].toDouble()},
+        {"draws", range(draws)},
+        {"triangles", range(triangles)},
+        {"passes", passes}, // 마지막 FrameProfiler::kHistory 프레임, GPU 는 timer query 를 못 읽은 프레임 제외
+    };
+
+    fbo.release();
+
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (opt.jsonPath.isEmpty()) {
+        std::fwrite(json.constData(), 1, json.size(), stdout);
+        return 0;
+    }
+    QFile out(opt.jsonPath);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate) || out.write(json) != json.size()) {
+        fail("cannot write " + opt.jsonPath);
+        return 1;
+    }
+    return 0;
+}
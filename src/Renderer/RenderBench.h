@@ -0,0 +1,34 @@
+#ifndef RENDERBENCH_H
+#define RENDERBENCH_H
+
+#include <QSize>
+#include <QString>
+#include <QStringList>
+
+/// 창 없이 GLWidget 의 그리기 코드를 QOffscreenSurface + FBO 에서 돌리는 렌더링 벤치마크.
+/// 정해진 궤도 카메라로 N 프레임을 그리고 프레임 시간 백분위, draw call / 삼각형 수를 JSON 으로 출력.
+/// GPU 없는 CI 나 렌더 노드에서도 (Mesa llvmpipe 등) 렌더 경로 회귀를 잡기 위한 것
+class RenderBench {
+public:
+    struct Options {
+        QString model;            // 비우면 번들 teddybear
+        int frames = 600;
+        int warmup = 30;
+        QSize size{1280, 720};
+        bool packed = false;      // VertexFormat::Packed 로 업로드
+        bool coneCulling = false; // 뷰어 기본값과 같음
+        bool lean = false;        // 업로드 뒤 CPU 사본 해제 (GLWidget::setLeanMemory)
+        QString jsonPath;         // 비우면 stdout
+        QString imagePath;        // 마지막 프레임을 이미지로 (눈으로 확인용)
+    };
+
+    /// main 에서 --bench-render 가 있으면 창 대신 부름 (QApplication 은 만들어진 상태). 반환값은 종료 코드
+    static int run(const QStringList &args);
+
+private:
+    static bool parseArgs(const QStringList &args, Options &opt);
+
+    static int run(const Options &opt);
+};
+
+#endif //RENDERBENCH_H
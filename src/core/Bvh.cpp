@@ -0,0 +1,327 @@
+#include "Bvh.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    constexpr int kBins = 16;
+    constexpr uint32_t kMaxLeaf = 8;              // SAH 가 leaf 를 고를 수 있는 최대 삼각형 수
+    constexpr int kMaxDepth = 64;                 // intersect 의 스택 크기 (넘으면 강제로 leaf)
+    constexpr size_t kParallelBinning = 1 << 16;  // 이보다 큰 구간은 bbox / binning 을 병렬로
+    constexpr float kTraversalCost = 2.0f;        // 내부 노드 방문 비용 (자식 bbox 두 개, 삼각형 교차 = 1)
+    constexpr float kInf = std::numeric_limits<float>::infinity();
+
+    struct Aabb {
+        glm::vec3 mn{kInf}, mx{-kInf};
+
+        void grow(const glm::vec3 &p) { mn = glm::min(mn, p); mx = glm::max(mx, p); }
+        void grow(const Aabb &b) { mn = glm::min(mn, b.mn); mx = glm::max(mx, b.mx); }
+
+        float area() const {
+            glm::vec3 d = mx - mn;
+            return (d.x < 0.0f) ? 0.0f : 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+    };
+
+    struct Bin {
+        Aabb box;
+        uint32_t count = 0;
+    };
+
+    /// 세 축 동시 binning 결과 (축마다 kBins 개)
+    struct Bins {
+        Bin bin[3][kBins];
+
+        void merge(const Bins &o) {
+            for (int a = 0; a < 3; ++a)
+                for (int b = 0; b < kBins; ++b) {
+                    bin[a][b].box.grow(o.bin[a][b].box);
+                    bin[a][b].count += o.bin[a][b].count;
+                }
+        }
+    };
+
+    /// [0, n) 을 블록으로 나눠 part(b, e, acc) 로 부분 결과를 만들고 merge 로 합침 (큰 구간만 병렬)
+    template<class T, class Part, class Merge>
+    T reduce(size_t n, Part &&part, Merge &&merge) {
+        const size_t blocks = n < kParallelBinning ? 1 : std::min<size_t>(parallel::threadCount(), n / (kParallelBinning / 4));
+        if (blocks <= 1) {
+            // 작은 구간은 할당 없이 바로 (노드 수만큼 불리므로)
+            T acc;
+            part(size_t(0), n, acc);
+            return acc;
+        }
+        std::vector<T> partial(blocks);
+        parallel::forEachTask(blocks, [&](size_t k) { part(n * k / blocks, n * (k + 1) / blocks, partial[k]); });
+        for (size_t k = 1; k < blocks; ++k) merge(partial[0], partial[k]);
+        return partial[0];
+    }
+}
+
+struct Bvh::Builder {
+    uint32_t *tris;                   // 서로 겹치지 않는 구간만 만지므로 스레드끼리 공유
+    std::vector<Aabb> box;            // 삼각형별 bbox (정점을 매번 간접 참조하지 않도록 미리)
+    const std::atomic<bool> *cancel;
+
+    bool cancelled() const { return cancel && cancel->load(std::memory_order_relaxed); }
+
+    /// bbox 중심의 2배 (binning 에만 쓰므로 0.5 곱은 생략)
+    glm::vec3 centroid(uint32_t t) const { return box[t].mn + box[t].mx; }
+
+    /// 구간의 삼각형 bbox (노드 bbox)
+    Aabb bounds(uint32_t first, uint32_t count) const {
+        return reduce<Aabb>(count, [&](size_t b, size_t e, Aabb &acc) {
+            for (size_t i = first + b; i < first + e; ++i) acc.grow(box[tris[i]]);
+        }, [](Aabb &a, const Aabb &b) { a.grow(b); });
+    }
+
+    /// 구간의 centroid bbox (binning 범위)
+    Aabb centroidBounds(uint32_t first, uint32_t count) const {
+        return reduce<Aabb>(count, [&](size_t b, size_t e, Aabb &acc) {
+            for (size_t i = first + b; i < first + e; ++i) acc.grow(centroid(tris[i]));
+        }, [](Aabb &a, const Aabb &b) { a.grow(b); });
+    }
+
+    /// leaf 로 둘지 SAH 로 나눌지 결정. 나누면 tris 를 제자리 분할하고 두 자식 노드를 채움
+    bool split(const Node &node, int depth, Node &left, Node &right) const {
+        const uint32_t first = node.first, count = node.count;
+        if (count <= 2 || depth >= kMaxDepth - 1) return false;
+
+        const Aabb cbox = centroidBounds(first, count);
+        const glm::vec3 ext = cbox.mx - cbox.mn;
+        if (!(std::max({ext.x, ext.y, ext.z}) > 0.0f)) {
+            // 중심이 전부 같은 점 → 위치로는 못 나눔. 작으면 leaf, 크면 반으로 (깊이만 줄이면 됨)
+            if (count <= kMaxLeaf) return false;
+            return splitAt(first, count, first + count / 2, left, right);
+        }
+
+        // 세 축을 한 번에 binning
+        glm::vec3 scale;
+        for (int a = 0; a < 3; ++a) scale[a] = ext[a] > 0.0f ? kBins / ext[a] : 0.0f;
+        auto binOf = [&](float c, int a) {
+            return std::min(kBins - 1, static_cast<int>((c - cbox.mn[a]) * scale[a]));
+        };
+        Bins bins = reduce<Bins>(count, [&](size_t b, size_t e, Bins &acc) {
+            for (size_t i = first + b; i < first + e; ++i) {
+                const uint32_t t = tris[i];
+                const Aabb &tb = box[t];
+                const glm::vec3 c = centroid(t);
+                for (int a = 0; a < 3; ++a) {
+                    Bin &bin = acc.bin[a][binOf(c[a], a)];
+                    bin.box.grow(tb);
+                    ++bin.count;
+                }
+            }
+        }, [](Bins &a, const Bins &b) { a.merge(b); });
+
+        // 왼쪽 / 오른쪽 누적으로 경계마다 SAH 비용
+        float bestCost = kInf;
+        int bestAxis = -1, bestBin = 0;
+        for (int a = 0; a < 3; ++a) {
+            if (scale[a] == 0.0f) continue;
+            float rightArea[kBins];
+            uint32_t rightCount[kBins];
+            Aabb acc;
+            uint32_t n = 0;
+            for (int b = kBins - 1; b > 0; --b) {
+                acc.grow(bins.bin[a][b].box);
+                n += bins.bin[a][b].count;
+                rightArea[b] = acc.area();
+                rightCount[b] = n;
+            }
+            acc = Aabb();
+            n = 0;
+            for (int b = 1; b < kBins; ++b) {
+                acc.grow(bins.bin[a][b - 1].box);
+                n += bins.bin[a][b - 1].count;
+                if (n == 0 || rightCount[b] == 0) continue;
+                float cost = acc.area() * n + rightArea[b] * rightCount[b];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = a;
+                    bestBin = b;
+                }
+            }
+        }
+        Aabb nodeBox;
+        nodeBox.grow(node.bmin);
+        nodeBox.grow(node.bmax);
+        const float parentArea = nodeBox.area();
+        const float splitCost = kTraversalCost + (parentArea > 0.0f ? bestCost / parentArea : 0.0f);
+        if (bestAxis < 0 || (splitCost >= float(count) && count <= kMaxLeaf)) return false;
+
+        const uint32_t mid = static_cast<uint32_t>(
+            std::partition(tris + first, tris + first + count, [&](uint32_t t) {
+                return binOf(centroid(t)[bestAxis], bestAxis) < bestBin;
+            }) - tris);
+
+        // 자식 bbox 는 bin bbox 들의 합 (다시 훑지 않음)
+        Aabb lb, rb;
+        for (int k = 0; k < kBins; ++k) (k < bestBin ? lb : rb).grow(bins.bin[bestAxis][k].box);
+        left = {lb.mn, first, lb.mx, mid - first};
+        right = {rb.mn, mid, rb.mx, first + count - mid};
+        return true;
+    }
+
+    /// mid 에서 그냥 자름 (위치로 나눌 수 없을 때)
+    bool splitAt(uint32_t first, uint32_t count, uint32_t mid, Node &left, Node &right) const {
+        const Aabb lb = bounds(first, mid - first), rb = bounds(mid, first + count - mid);
+        left = {lb.mn, first, lb.mx, mid - first};
+        right = {rb.mn, mid, rb.mx, first + count - mid};
+        return true;
+    }
+
+    /// nodes[root] (leaf 상태) 아래를 전부 만듦. 자식은 항상 nodes 끝에 두 개씩 붙음
+    void buildSubtree(std::vector<Node> &nodes, uint32_t root, int depth) const {
+        std::vector<std::pair<uint32_t, int>> stack{{root, depth}};
+        while (!stack.empty() && !cancelled()) {
+            auto [n, d] = stack.back();
+            stack.pop_back();
+            Node left, right;
+            if (!split(nodes[n], d, left, right)) continue;
+            const uint32_t child = static_cast<uint32_t>(nodes.size());
+            nodes[n].first = child;
+            nodes[n].count = 0;
+            nodes.push_back(left);
+            nodes.push_back(right);
+            stack.push_back({child, d + 1});
+            stack.push_back({child + 1, d + 1});
+        }
+    }
+};
+
+bool Bvh::build(const glm::vec3 *positions, const uint32_t *indices, size_t triangleCount,
+                const std::atomic<bool> *cancel) {
+    nodes_.clear();
+    tris_.clear();
+    if (triangleCount == 0) return true;
+
+    Builder b{nullptr, {}, cancel};
+    tris_.resize(triangleCount);
+    b.box.resize(triangleCount);
+    b.tris = tris_.data();
+    parallel::forRange(triangleCount, [&](size_t s, size_t e) {
+        for (size_t t = s; t < e; ++t) {
+            tris_[t] = static_cast<uint32_t>(t);
+            Aabb &tb = b.box[t];
+            tb.grow(positions[indices[3 * t]]);
+            tb.grow(positions[indices[3 * t + 1]]);
+            tb.grow(positions[indices[3 * t + 2]]);
+        }
+    });
+
+    const Aabb box = b.bounds(0, static_cast<uint32_t>(triangleCount));
+    nodes_.push_back({box.mn, 0, box.mx, static_cast<uint32_t>(triangleCount)});
+
+    // 1) 큰 노드는 여기서 (binning 만 병렬로) 나누고, 충분히 작아진 노드는 서브트리 작업으로 미룸
+    const size_t subtreeSize = std::max<size_t>(4096, triangleCount / (8 * parallel::threadCount()));
+    std::vector<std::pair<uint32_t, int>> stack{{0u, 0}}, pending;
+    while (!stack.empty() && !b.cancelled()) {
+        auto [n, d] = stack.back();
+        stack.pop_back();
+        if (nodes_[n].count <= subtreeSize) {
+            pending.push_back({n, d});
+            continue;
+        }
+        Node left, right;
+        if (!b.split(nodes_[n], d, left, right)) continue;
+        const uint32_t child = static_cast<uint32_t>(nodes_.size());
+        nodes_[n].first = child;
+        nodes_[n].count = 0;
+        nodes_.push_back(left);
+        nodes_.push_back(right);
+        stack.push_back({child, d + 1});
+        stack.push_back({child + 1, d + 1});
+    }
+
+    // 2) 서브트리는 각자 지역 배열에 병렬로 만든 뒤
+    std::vector<std::vector<Node>> sub(pending.size());
+    parallel::forEachTask(pending.size(), [&](size_t i) {
+        sub[i].push_back(nodes_[pending[i].first]);
+        b.buildSubtree(sub[i], 0, pending[i].second);
+    });
+    if (b.cancelled()) {
+        nodes_.clear();
+        tris_.clear();
+        return false;
+    }
+
+    // 3) 순서대로 이어 붙임. 지역 번호 k (≥ 1) → base + k - 1, 지역 루트는 원래 자리에 덮어씀
+    for (size_t i = 0; i < pending.size(); ++i) {
+        const uint32_t base = static_cast<uint32_t>(nodes_.size());
+        auto fix = [base](Node nd) {
+            if (nd.count == 0) nd.first = base + nd.first - 1;
+            return nd;
+        };
+        nodes_[pending[i].first] = fix(sub[i][0]);
+        for (size_t k = 1; k < sub[i].size(); ++k) nodes_.push_back(fix(sub[i][k]));
+        std::vector<Node>().swap(sub[i]);
+    }
+    return true;
+}
+
+bool Bvh::intersect(const glm::vec3 *positions, const uint32_t *indices,
+                    const glm::vec3 &orig, const glm::vec3 &dir, Hit &hit) const {
+    if (nodes_.empty()) return false;
+    const glm::vec3 inv = glm::vec3(1.0f) / dir;
+    float best = kInf;
+
+    // 노드 bbox 진입 거리 (안 맞거나 지금 최선보다 멀면 inf)
+    auto enter = [&](const Node &n) {
+        glm::vec3 t0 = (n.bmin - orig) * inv, t1 = (n.bmax - orig) * inv;
+        glm::vec3 lo = glm::min(t0, t1), hi = glm::max(t0, t1);
+        float tn = std::max({lo.x, lo.y, lo.z, 0.0f});
+        float tf = std::min({hi.x, hi.y, hi.z, best});
+        return tn <= tf ? tn : kInf;
+    };
+
+    // Möller–Trumbore (양면)
+    auto triangle = [&](uint32_t t) {
+        const glm::vec3 &p0 = positions[indices[3 * t]];
+        const glm::vec3 e1 = positions[indices[3 * t + 1]] - p0, e2 = positions[indices[3 * t + 2]] - p0;
+        const glm::vec3 pv = glm::cross(dir, e2);
+        const float det = glm::dot(e1, pv);
+        if (std::abs(det) < 1e-20f) return;
+        const float invDet = 1.0f / det;
+        const glm::vec3 tv = orig - p0;
+        const float u = glm::dot(tv, pv) * invDet;
+        if (u < 0.0f || u > 1.0f) return;
+        const glm::vec3 qv = glm::cross(tv, e1);
+        const float v = glm::dot(dir, qv) * invDet;
+        if (v < 0.0f || u + v > 1.0f) return;
+        const float d = glm::dot(e2, qv) * invDet;
+        if (d > 0.0f && d < best) {
+            best = d;
+            hit = {t, d, u, v};
+        }
+    };
+
+    struct Entry { uint32_t node; float dist; };
+    Entry stack[kMaxDepth];
+    int top = 0;
+    if (enter(nodes_[0]) == kInf) return false;
+    uint32_t cur = 0;
+    for (;;) {
+        const Node &n = nodes_[cur];
+        if (n.count) {
+            for (uint32_t i = n.first; i < n.first + n.count; ++i) triangle(tris_[i]);
+        } else {
+            // 가까운 자식부터, 먼 자식은 스택에
+            uint32_t a = n.first, c = n.first + 1;
+            float da = enter(nodes_[a]), dc = enter(nodes_[c]);
+            if (dc < da) { std::swap(a, c); std::swap(da, dc); }
+            if (da != kInf) {
+                if (dc != kInf) stack[top++] = {c, dc};
+                cur = a;
+                continue;
+            }
+        }
+        // 스택에서 지금 최선보다 가까운 것만 꺼냄
+        for (;;) {
+            if (top == 0) return best != kInf;
+            Entry e = stack[--top];
+            if (e.dist < best) { cur = e.node; break; }
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+/// 삼각형 메쉬용 binned SAH BVH (레이 피킹).
+/// 정점·인덱스 배열은 복사하지 않고 삼각형 번호만 재배치해서 가짐 → build 와 intersect 에 같은 배열을 넘겨야 함
+class Bvh {
+public:
+    struct Hit {
+        uint32_t triangle = 0;
+        float t = 0.0f;          // orig + t·dir
+        float u = 0.0f, v = 0.0f; // 무게중심 좌표: p = (1-u-v)·p0 + u·p1 + v·p2
+    };
+
+    /// 위쪽 몇 단계는 binning 을 병렬로, 그 아래 서브트리들은 서로 다른 스레드에서 만듦.
+    /// cancel 이 켜지면 비운 채로 false
+    bool build(const glm::vec3 *positions, const uint32_t *indices, size_t triangleCount,
+               const std::atomic<bool> *cancel = nullptr);
+
+    /// 가장 가까운 교차 (양면, t > 0)
+    bool intersect(const glm::vec3 *positions, const uint32_t *indices,
+                   const glm::vec3 &orig, const glm::vec3 &dir, Hit &hit) const;
+
+    bool empty() const { return nodes_.empty(); }
+    size_t nodeCount() const { return nodes_.size(); }
+    size_t memoryBytes() const { return nodes_.size() * sizeof(Node) + tris_.size() * sizeof(uint32_t); }
+
+private:
+    /// count > 0 이면 leaf (tris_[first, first + count)), 아니면 자식은 first, first + 1
+    struct Node {
+        glm::vec3 bmin;
+        uint32_t first;
+        glm::vec3 bmax;
+        uint32_t count;
+    };
+    static_assert(sizeof(Node) == 32, "Node should fill half a cache line");
+
+    struct Builder;
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> tris_;
+};
+
+#endif //BVH_H
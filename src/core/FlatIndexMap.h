@@ -0,0 +1,78 @@
+#ifndef FLATINDEXMAP_H
+#define FLATINDEXMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// murmur3 fmix64 – 하위 비트까지 고르게 섞임
+inline uint64_t hashMix64(uint64_t h) {
+    h ^= h >> 33; h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/// 키를 따로 저장하지 않고 외부 배열(keys)의 인덱스만 담는 open addressing 해시 테이블.
+/// 슬롯은 {인덱스, 해시 상위 32비트} 8바이트, linear probing, load factor ≤ 0.5.
+/// 노드 할당이 없고 탐색은 대부분 캐시 라인 하나 안에서 끝남
+template<class Key, class Hash, class Eq>
+class FlatIndexMap {
+public:
+    explicit FlatIndexMap(size_t expected) { rehash(capacityFor(expected), nullptr); }
+
+    /// keys 에 key 와 같은 값이 이미 있으면 그 인덱스, 없으면 newIndex 를 등록하고 그대로 반환.
+    /// 호출자는 newIndex 가 반환되면 keys[newIndex] 에 key 를 넣어야 함
+    uint32_t findOrInsert(const Key &key, uint32_t newIndex, const Key *keys) {
+        if ((size_ + 1) * 2 > slots_.size()) rehash(slots_.size() * 2, keys);
+
+        const uint64_t h = Hash()(key);
+        const uint32_t tag = static_cast<uint32_t>(h >> 32);
+        for (size_t i = h & mask_;; i = (i + 1) & mask_) {
+            Slot &s = slots_[i];
+            if (s.index == kEmpty) {
+                s = {newIndex, tag};
+                ++size_;
+                return newIndex;
+            }
+            if (s.tag == tag && Eq()(keys[s.index], key))
+                return s.index;
+        }
+    }
+
+    size_t size() const { return size_; }
+
+private:
+    static constexpr uint32_t kEmpty = 0xFFFFFFFFu;
+
+    struct Slot {
+        uint32_t index;
+        uint32_t tag;
+    };
+
+    static size_t capacityFor(size_t expected) {
+        size_t cap = 16;
+        while (cap < expected * 2) cap *= 2;
+        return cap;
+    }
+
+    void rehash(size_t cap, const Key *keys) {
+        std::vector<Slot> old;
+        old.swap(slots_);
+        slots_.assign(cap, Slot{kEmpty, 0});
+        mask_ = cap - 1;
+        for (const Slot &s : old) {
+            if (s.index == kEmpty) continue;
+            const uint64_t h = Hash()(keys[s.index]);
+            size_t i = h & mask_;
+            while (slots_[i].index != kEmpty) i = (i + 1) & mask_;
+            slots_[i] = {s.index, static_cast<uint32_t>(h >> 32)};
+        }
+    }
+
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    size_t size_ = 0;
+};
+
+#endif //FLATINDEXMAP_H
@@ -0,0 +1,307 @@
+#include "GeometryKernels.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define GEOM_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define GEOM_TARGET(t)
+#else
+// 파일 전체를 -mavx2 로 빌드하지 않고 함수 단위로만 켬 (AVX2 없는 CPU 에서도 실행 가능)
+#define GEOM_TARGET(t) __attribute__((target(t)))
+#endif
+#endif
+
+namespace {
+    using geom::Isa;
+    using geom::SoA3;
+
+    Isa detectIsa() {
+#if GEOM_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+        int r[4];
+        __cpuid(r, 0);
+        const int maxLeaf = r[0];
+        __cpuid(r, 1);
+        const bool sse2 = r[3] & (1 << 26);
+        const bool avx = (r[2] & (1 << 27)) && (r[2] & (1 << 28))  // OSXSAVE + AVX
+                         && (_xgetbv(0) & 6) == 6;                 // OS 가 YMM 상태 저장
+        bool avx2 = false;
+        if (avx && maxLeaf >= 7) {
+            __cpuidex(r, 7, 0);
+            avx2 = r[1] & (1 << 5);
+        }
+#else
+        __builtin_cpu_init();
+        const bool sse2 = __builtin_cpu_supports("sse2");
+        const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+        if (avx2) return Isa::AVX2;
+        if (sse2) return Isa::SSE2;
+#endif
+        return Isa::Scalar;
+    }
+
+    std::atomic<int> g_isa{-1};
+
+    /* ---------- scalar (glm 그대로 – 기준 결과) ---------- */
+
+    void boundsScalar(const SoA3 &p, size_t b, size_t e, glm::vec3 &mn, glm::vec3 &mx) {
+        for (size_t i = b; i < e; ++i) {
+            glm::vec3 q(p.x[i], p.y[i], p.z[i]);
+            mn = glm::min(mn, q);
+            mx = glm::max(mx, q);
+        }
+    }
+
+    void faceNormalsScalar(const SoA3 &p, const uint32_t *idx, size_t b, size_t e, glm::vec3 *out) {
+        for (size_t f = b; f < e; ++f) {
+            const uint32_t *t = idx + 3 * f;
+            glm::vec3 p0(p.x[t[0]], p.y[t[0]], p.z[t[0]]);
+            glm::vec3 p1(p.x[t[1]], p.y[t[1]], p.z[t[1]]);
+            glm::vec3 p2(p.x[t[2]], p.y[t[2]], p.z[t[2]]);
+            out[f] = glm::normalize(glm::cross(p1 - p0, p2 - p0));
+        }
+    }
+
+    void normalizeScalar(SoA3 &v, size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+            glm::vec3 n = glm::normalize(glm::vec3(v.x[i], v.y[i], v.z[i]));
+            v.x[i] = n.x; v.y[i] = n.y; v.z[i] = n.z;
+        }
+    }
+
+#if GEOM_X86
+    /* ---------- SSE2 (4‑wide) ----------
+       glm::normalize 는 v * (1 / sqrt(dot)) 이고 dot 은 (x*x + y*y) + z*z 순서.
+       rsqrt 근사 대신 sqrt + div 를 써서 scalar 와 같은 값을 냄 */
+
+    GEOM_TARGET("sse2")
+    inline __m128 gather4(const float *a, const uint32_t *t, int k) {
+        return _mm_setr_ps(a[t[k]], a[t[3 + k]], a[t[6 + k]], a[t[9 + k]]);
+    }
+
+    GEOM_TARGET("sse2")
+    inline __m128 invLength4(__m128 x, __m128 y, __m128 z) {
+        __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+        return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(d));
+    }
+
+    GEOM_TARGET("sse2")
+    void boundsSSE2(const SoA3 &p, size_t b, size_t e, glm::vec3 &mn, glm::vec3 &mx) {
+        const float *px = p.x.data(), *py = p.y.data(), *pz = p.z.data();
+        __m128 nx = _mm_set1_ps(mn.x), ny = _mm_set1_ps(mn.y), nz = _mm_set1_ps(mn.z);
+        __m128 xx = _mm_set1_ps(mx.x), xy = _mm_set1_ps(mx.y), xz = _mm_set1_ps(mx.z);
+        size_t i = b;
+        for (; i + 4 <= e; i += 4) {
+            __m128 x = _mm_loadu_ps(px + i), y = _mm_loadu_ps(py + i), z = _mm_loadu_ps(pz + i);
+            // minps(a, b) = a < b ? a : b → 새 값이 NaN 이면 누적값 유지 (glm::min 과 동일)
+            nx = _mm_min_ps(x, nx); ny = _mm_min_ps(y, ny); nz = _mm_min_ps(z, nz);
+            xx = _mm_max_ps(x, xx); xy = _mm_max_ps(y, xy); xz = _mm_max_ps(z, xz);
+        }
+        alignas(16) float l[6][4];
+        _mm_store_ps(l[0], nx); _mm_store_ps(l[1], ny); _mm_store_ps(l[2], nz);
+        _mm_store_ps(l[3], xx); _mm_store_ps(l[4], xy); _mm_store_ps(l[5], xz);
+        for (int k = 0; k < 4; ++k) {
+            mn = glm::min(mn, glm::vec3(l[0][k], l[1][k], l[2][k]));
+            mx = glm::max(mx, glm::vec3(l[3][k], l[4][k], l[5][k]));
+        }
+        boundsScalar(p, i, e, mn, mx);
+    }
+
+    GEOM_TARGET("sse2")
+    void faceNormalsSSE2(const SoA3 &p, const uint32_t *idx, size_t b, size_t e, glm::vec3 *out) {
+        const float *px = p.x.data(), *py = p.y.data(), *pz = p.z.data();
+        size_t f = b;
+        for (; f + 4 <= e; f += 4) {
+            const uint32_t *t = idx + 3 * f;
+            __m128 ax = gather4(px, t, 0), ay = gather4(py, t, 0), az = gather4(pz, t, 0);
+            __m128 e1x = _mm_sub_ps(gather4(px, t, 1), ax);
+            __m128 e1y = _mm_sub_ps(gather4(py, t, 1), ay);
+            __m128 e1z = _mm_sub_ps(gather4(pz, t, 1), az);
+            __m128 e2x = _mm_sub_ps(gather4(px, t, 2), ax);
+            __m128 e2y = _mm_sub_ps(gather4(py, t, 2), ay);
+            __m128 e2z = _mm_sub_ps(gather4(pz, t, 2), az);
+
+            __m128 cx = _mm_sub_ps(_mm_mul_ps(e1y, e2z), _mm_mul_ps(e2y, e1z));
+            __m128 cy = _mm_sub_ps(_mm_mul_ps(e1z, e2x), _mm_mul_ps(e2z, e1x));
+            __m128 cz = _mm_sub_ps(_mm_mul_ps(e1x, e2y), _mm_mul_ps(e2x, e1y));
+            __m128 inv = invLength4(cx, cy, cz);
+
+            alignas(16) float r[3][4];
+            _mm_store_ps(r[0], _mm_mul_ps(cx, inv));
+            _mm_store_ps(r[1], _mm_mul_ps(cy, inv));
+            _mm_store_ps(r[2], _mm_mul_ps(cz, inv));
+            for (int k = 0; k < 4; ++k) out[f + k] = {r[0][k], r[1][k], r[2][k]};
+        }
+        faceNormalsScalar(p, idx, f, e, out);
+    }
+
+    GEOM_TARGET("sse2")
+    void normalizeSSE2(SoA3 &v, size_t b, size_t e) {
+        float *vx = v.x.data(), *vy = v.y.data(), *vz = v.z.data();
+        size_t i = b;
+        for (; i + 4 <= e; i += 4) {
+            __m128 x = _mm_loadu_ps(vx + i), y = _mm_loadu_ps(vy + i), z = _mm_loadu_ps(vz + i);
+            __m128 inv = invLength4(x, y, z);
+            _mm_storeu_ps(vx + i, _mm_mul_ps(x, inv));
+            _mm_storeu_ps(vy + i, _mm_mul_ps(y, inv));
+            _mm_storeu_ps(vz + i, _mm_mul_ps(z, inv));
+        }
+        normalizeScalar(v, i, e);
+    }
+
+    /* ---------- AVX2 (8‑wide) ---------- */
+
+    GEOM_TARGET("avx2")
+    inline __m256 invLength8(__m256 x, __m256 y, __m256 z) {
+        __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)),
+                                 _mm256_mul_ps(z, z));
+        return _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(d));
+    }
+
+    GEOM_TARGET("avx2")
+    void boundsAVX2(const SoA3 &p, size_t b, size_t e, glm::vec3 &mn, glm::vec3 &mx) {
+        const float *px = p.x.data(), *py = p.y.data(), *pz = p.z.data();
+        __m256 nx = _mm256_set1_ps(mn.x), ny = _mm256_set1_ps(mn.y), nz = _mm256_set1_ps(mn.z);
+        __m256 xx = _mm256_set1_ps(mx.x), xy = _mm256_set1_ps(mx.y), xz = _mm256_set1_ps(mx.z);
+        size_t i = b;
+        for (; i + 8 <= e; i += 8) {
+            __m256 x = _mm256_loadu_ps(px + i), y = _mm256_loadu_ps(py + i), z = _mm256_loadu_ps(pz + i);
+            nx = _mm256_min_ps(x, nx); ny = _mm256_min_ps(y, ny); nz = _mm256_min_ps(z, nz);
+            xx = _mm256_max_ps(x, xx); xy = _mm256_max_ps(y, xy); xz = _mm256_max_ps(z, xz);
+        }
+        alignas(32) float l[6][8];
+        _mm256_store_ps(l[0], nx); _mm256_store_ps(l[1], ny); _mm256_store_ps(l[2], nz);
+        _mm256_store_ps(l[3], xx); _mm256_store_ps(l[4], xy); _mm256_store_ps(l[5], xz);
+        for (int k = 0; k < 8; ++k) {
+            mn = glm::min(mn, glm::vec3(l[0][k], l[1][k], l[2][k]));
+            mx = glm::max(mx, glm::vec3(l[3][k], l[4][k], l[5][k]));
+        }
+        boundsScalar(p, i, e, mn, mx);
+    }
+
+    // vgatherdps 는 CPU 에 따라 스칼라 load 8번보다 느려서 set 으로 묶음
+    GEOM_TARGET("avx2")
+    inline __m256 gather8(const float *a, const uint32_t *t, int k) {
+        return _mm256_setr_ps(a[t[k]], a[t[3 + k]], a[t[6 + k]], a[t[9 + k]],
+                              a[t[12 + k]], a[t[15 + k]], a[t[18 + k]], a[t[21 + k]]);
+    }
+
+    GEOM_TARGET("avx2")
+    void faceNormalsAVX2(const SoA3 &p, const uint32_t *idx, size_t b, size_t e, glm::vec3 *out) {
+        const float *px = p.x.data(), *py = p.y.data(), *pz = p.z.data();
+        size_t f = b;
+        for (; f + 8 <= e; f += 8) {
+            const uint32_t *t = idx + 3 * f;
+            __m256 ax = gather8(px, t, 0), ay = gather8(py, t, 0), az = gather8(pz, t, 0);
+            __m256 e1x = _mm256_sub_ps(gather8(px, t, 1), ax);
+            __m256 e1y = _mm256_sub_ps(gather8(py, t, 1), ay);
+            __m256 e1z = _mm256_sub_ps(gather8(pz, t, 1), az);
+            __m256 e2x = _mm256_sub_ps(gather8(px, t, 2), ax);
+            __m256 e2y = _mm256_sub_ps(gather8(py, t, 2), ay);
+            __m256 e2z = _mm256_sub_ps(gather8(pz, t, 2), az);
+
+            __m256 cx = _mm256_sub_ps(_mm256_mul_ps(e1y, e2z), _mm256_mul_ps(e2y, e1z));
+            __m256 cy = _mm256_sub_ps(_mm256_mul_ps(e1z, e2x), _mm256_mul_ps(e2z, e1x));
+            __m256 cz = _mm256_sub_ps(_mm256_mul_ps(e1x, e2y), _mm256_mul_ps(e2x, e1y));
+            __m256 inv = invLength8(cx, cy, cz);
+
+            alignas(32) float r[3][8];
+            _mm256_store_ps(r[0], _mm256_mul_ps(cx, inv));
+            _mm256_store_ps(r[1], _mm256_mul_ps(cy, inv));
+            _mm256_store_ps(r[2], _mm256_mul_ps(cz, inv));
+            for (int k = 0; k < 8; ++k) out[f + k] = {r[0][k], r[1][k], r[2][k]};
+        }
+        faceNormalsScalar(p, idx, f, e, out);
+    }
+
+    GEOM_TARGET("avx2")
+    void normalizeAVX2(SoA3 &v, size_t b, size_t e) {
+        float *vx = v.x.data(), *vy = v.y.data(), *vz = v.z.data();
+        size_t i = b;
+        for (; i + 8 <= e; i += 8) {
+            __m256 x = _mm256_loadu_ps(vx + i), y = _mm256_loadu_ps(vy + i), z = _mm256_loadu_ps(vz + i);
+            __m256 inv = invLength8(x, y, z);
+            _mm256_storeu_ps(vx + i, _mm256_mul_ps(x, inv));
+            _mm256_storeu_ps(vy + i, _mm256_mul_ps(y, inv));
+            _mm256_storeu_ps(vz + i, _mm256_mul_ps(z, inv));
+        }
+        normalizeScalar(v, i, e);
+    }
+#endif
+}
+
+namespace geom {
+    Isa activeIsa() {
+        int v = g_isa.load(std::memory_order_relaxed);
+        if (v < 0) {
+            v = static_cast<int>(detectIsa());
+            g_isa.store(v, std::memory_order_relaxed);
+        }
+        return static_cast<Isa>(v);
+    }
+
+    void setIsa(Isa isa) {
+        int v = std::min(static_cast<int>(isa), static_cast<int>(detectIsa()));
+        g_isa.store(v, std::memory_order_relaxed);
+    }
+
+    const char *isaName(Isa isa) {
+        switch (isa) {
+            case Isa::AVX2: return "avx2";
+            case Isa::SSE2: return "sse2";
+            case Isa::Scalar: break;
+        }
+        return "scalar";
+    }
+
+    void toSoA(const glm::vec3 *src, size_t n, SoA3 &dst) {
+        dst.resize(n);
+        parallel::forRange(n, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                dst.x[i] = src[i].x;
+                dst.y[i] = src[i].y;
+                dst.z[i] = src[i].z;
+            }
+        }, 1 << 16);
+    }
+
+    void toAoS(const SoA3 &src, size_t b, size_t e, glm::vec3 *dst) {
+        for (size_t i = b; i < e; ++i)
+            dst[i] = {src.x[i], src.y[i], src.z[i]};
+    }
+
+    void bounds(const SoA3 &p, size_t b, size_t e, glm::vec3 &mn, glm::vec3 &mx) {
+        switch (activeIsa()) {
+#if GEOM_X86
+            case Isa::AVX2: boundsAVX2(p, b, e, mn, mx); return;
+            case Isa::SSE2: boundsSSE2(p, b, e, mn, mx); return;
+#endif
+            default: boundsScalar(p, b, e, mn, mx); return;
+        }
+    }
+
+    void faceNormals(const SoA3 &p, const uint32_t *idx, size_t b, size_t e, glm::vec3 *out) {
+        switch (activeIsa()) {
+#if GEOM_X86
+            case Isa::AVX2: faceNormalsAVX2(p, idx, b, e, out); return;
+            case Isa::SSE2: faceNormalsSSE2(p, idx, b, e, out); return;
+#endif
+            default: faceNormalsScalar(p, idx, b, e, out); return;
+        }
+    }
+
+    void normalize(SoA3 &v, size_t b, size_t e) {
+        switch (activeIsa()) {
+#if GEOM_X86
+            case Isa::AVX2: normalizeAVX2(v, b, e); return;
+            case Isa::SSE2: normalizeSSE2(v, b, e); return;
+#endif
+            default: normalizeScalar(v, b, e); return;
+        }
+    }
+}
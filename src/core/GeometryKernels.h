@@ -0,0 +1,48 @@
+#ifndef GEOMETRYKERNELS_H
+#define GEOMETRYKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+/// 위치 / 노멀 배열에 대한 SIMD 커널 (AVX2 · SSE2 · scalar, 실행 중 CPU 를 보고 선택).
+/// 모든 경로가 glm 과 같은 연산 순서를 써서 결과가 비트 단위로 같음 (FMA 미사용)
+namespace geom {
+    enum class Isa { Scalar, SSE2, AVX2 };
+
+    /// 현재 사용하는 명령어 집합 (처음 호출 시 CPU 검사)
+    Isa activeIsa();
+
+    /// 벤치마크 비교용 강제 지정. CPU 가 지원하지 않는 값이면 지원하는 최상위로 내려감
+    void setIsa(Isa isa);
+
+    const char *isaName(Isa isa);
+
+    /// glm::vec3 배열의 SoA 사본 (x / y / z 가 각각 연속)
+    struct SoA3 {
+        std::vector<float> x, y, z;
+
+        size_t size() const { return x.size(); }
+        void resize(size_t n) { x.resize(n); y.resize(n); z.resize(n); }
+        void clear() { x = {}; y = {}; z = {}; }  // 메모리까지 반환
+    };
+
+    /// AoS → SoA 변환. 큰 배열은 병렬
+    void toSoA(const glm::vec3 *src, size_t n, SoA3 &dst);
+
+    /// SoA [b, e) → AoS dst[b, e)
+    void toAoS(const SoA3 &src, size_t b, size_t e, glm::vec3 *dst);
+
+    /// [b, e) 구간의 min / max 를 mn / mx 에 누적 (glm::min / glm::max 와 같은 NaN 처리)
+    void bounds(const SoA3 &p, size_t b, size_t e, glm::vec3 &mn, glm::vec3 &mx);
+
+    /// 삼각형 [b, e) 의 normalize(cross(p1 - p0, p2 - p0)) 를 out[b, e) 에 기록.
+    /// idx 는 삼각형당 정점 인덱스 3개
+    void faceNormals(const SoA3 &p, const uint32_t *idx, size_t b, size_t e, glm::vec3 *out);
+
+    /// [b, e) 를 제자리에서 glm::normalize
+    void normalize(SoA3 &v, size_t b, size_t e);
+}
+
+#endif //GEOMETRYKERNELS_H
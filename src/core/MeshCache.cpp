@@ -0,0 +1,328 @@
+#include "MeshCache.h"
+#include "FlatIndexMap.h"
+#include "MappedFile.h"
+#include "ModelLoader.h"
+#include "Parallel.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr char kMagic[8] = {'O', 'B', 'J', 'V', 'C', 'A', 'C', 'H'};
+    // 저장 형식이나 로드 파이프라인 결과가 바뀌면 올림
+    constexpr uint32_t kVersion = 7;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t flags;          // 결과에 영향을 주는 로드 옵션
+        uint64_t srcSize;
+        int64_t srcMtime;
+        uint64_t srcHash;
+        uint64_t payloadHash;    // 아래 섹션 전체의 해시 (깨진 캐시 검출용)
+        uint64_t pathLen;
+        uint64_t rawPos, rawIdx, faceNrm, vertNrm, vertices, indices, faceMatIds, meshletTris, sourceFaces, sourceVertices,
+                 materialBytes;
+        float center[3];
+        float maxExtent;
+    };
+
+    uint64_t hashBlock(const unsigned char *p, size_t n) {
+        uint64_t h = 0x9E3779B97F4A7C15ULL ^ n;
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            uint64_t w;
+            std::memcpy(&w, p + i, 8);
+            h = (h ^ hashMix64(w)) * 0x9E3779B97F4A7C15ULL;
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, p + i, n - i);
+        return hashMix64(h ^ tail);
+    }
+
+    bool sourceStat(const std::string &path, uint64_t &size, int64_t &mtime) {
+        std::error_code ec;
+        size = fs::file_size(path, ec);
+        if (ec) return false;
+        auto t = fs::last_write_time(path, ec);
+        if (ec) return false;
+        mtime = static_cast<int64_t>(t.time_since_epoch().count());
+        return true;
+    }
+
+    bool hashFile(const std::string &path, uint64_t &hash) {
+        MappedFile f;
+        if (!f.open(path)) return false;
+        hash = MeshCache::hashBytes(f.data(), f.size());
+        return true;
+    }
+
+    // --- 재질 직렬화 (tinyobj::material_t 중 뷰어가 쓰는 필드만) ---
+    void putStr(std::string &out, const std::string &s) {
+        uint32_t n = static_cast<uint32_t>(s.size());
+        out.append(reinterpret_cast<const char *>(&n), sizeof n);
+        out.append(s);
+    }
+
+    template<class T>
+    void putPod(std::string &out, const T &v) {
+        out.append(reinterpret_cast<const char *>(&v), sizeof(T));
+    }
+
+    std::string packMaterials(const std::vector<tinyobj::material_t> &mats) {
+        std::string out;
+        putPod(out, static_cast<uint32_t>(mats.size()));
+        for (const auto &m : mats) {
+            putStr(out, m.name);
+            putPod(out, m.ambient);
+            putPod(out, m.diffuse);
+            putPod(out, m.specular);
+            putPod(out, m.transmittance);
+            putPod(out, m.emission);
+            putPod(out, m.shininess);
+            putPod(out, m.ior);
+            putPod(out, m.dissolve);
+            putPod(out, m.illum);
+            putStr(out, m.ambient_texname);
+            putStr(out, m.diffuse_texname);
+            putStr(out, m.specular_texname);
+            putStr(out, m.specular_highlight_texname);
+            putStr(out, m.bump_texname);
+            putStr(out, m.displacement_texname);
+            putStr(out, m.alpha_texname);
+        }
+        return out;
+    }
+
+    /// 경계 검사를 하며 앞에서부터 읽는 커서
+    struct Reader {
+        const char *p, *end;
+
+        bool take(void *dst, size_t n) {
+            if (static_cast<size_t>(end - p) < n) return false;
+            std::memcpy(dst, p, n);
+            p += n;
+            return true;
+        }
+
+        bool str(std::string &s) {
+            uint32_t n;
+            if (!take(&n, sizeof n) || static_cast<size_t>(end - p) < n) return false;
+            s.assign(p, n);
+            p += n;
+            return true;
+        }
+
+        template<class T>
+        bool vec(std::vector<T> &v, uint64_t count) {
+            if (count > static_cast<size_t>(end - p) / sizeof(T)) return false;
+            v.resize(count);
+            return take(v.data(), count * sizeof(T));
+        }
+    };
+
+    bool unpackMaterials(const char *data, size_t size, std::vector<tinyobj::material_t> &mats) {
+        Reader r{data, data + size};
+        uint32_t n;
+        if (!r.take(&n, sizeof n)) return false;
+        mats.clear();
+        for (uint32_t i = 0; i < n; ++i) {
+            tinyobj::material_t m;
+            bool ok = r.str(m.name)
+                      && r.take(&m.ambient, sizeof m.ambient)
+                      && r.take(&m.diffuse, sizeof m.diffuse)
+                      && r.take(&m.specular, sizeof m.specular)
+                      && r.take(&m.transmittance, sizeof m.transmittance)
+                      && r.take(&m.emission, sizeof m.emission)
+                      && r.take(&m.shininess, sizeof m.shininess)
+                      && r.take(&m.ior, sizeof m.ior)
+                      && r.take(&m.dissolve, sizeof m.dissolve)
+                      && r.take(&m.illum, sizeof m.illum)
+                      && r.str(m.ambient_texname)
+                      && r.str(m.diffuse_texname)
+                      && r.str(m.specular_texname)
+                      && r.str(m.specular_highlight_texname)
+                      && r.str(m.bump_texname)
+                      && r.str(m.displacement_texname)
+                      && r.str(m.alpha_texname);
+            if (!ok) return false;
+            mats.push_back(std::move(m));
+        }
+        return r.p == r.end;
+    }
+}
+
+std::string MeshCache::cachePath(const std::string &objPath) {
+    return objPath + ".meshcache";
+}
+
+uint64_t MeshCache::hashBytes(const void *data, size_t size) {
+    constexpr size_t kBlock = size_t(1) << 20;
+    const auto *p = static_cast<const unsigned char *>(data);
+    const size_t blocks = (size + kBlock - 1) / kBlock;
+    if (blocks <= 1) return hashBlock(p, size);
+
+    std::vector<uint64_t> bh(blocks);
+    parallel::forRange(blocks, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i)
+            bh[i] = hashBlock(p + i * kBlock, std::min(kBlock, size - i * kBlock));
+    }, 4);
+    uint64_t h = size;
+    for (uint64_t x : bh) h = hashMix64(h ^ x) * 0x9E3779B97F4A7C15ULL;
+    return h;
+}
+
+namespace {
+    /// 헤더 / 원본 확인까지 하고 r 을 payload 시작에 둠. 통과하면 Hit
+    MeshCache::Result openChecked(const std::string &objPath, uint32_t flags, MappedFile &f, Header &h, Reader &r) {
+        using Result = MeshCache::Result;
+        if (!f.open(MeshCache::cachePath(objPath))) return Result::Missing;
+
+        r = Reader{f.data(), f.data() + f.size()};
+        if (!r.take(&h, sizeof h) || std::memcmp(h.magic, kMagic, sizeof kMagic) != 0)
+            return Result::Corrupt;
+        if (h.version != kVersion || h.flags != flags) return Result::Stale;
+
+        // 원본 확인: 크기·mtime 이 같으면 그대로 신뢰, mtime 만 다르면 내용 해시로 판단
+        uint64_t srcSize;
+        int64_t srcMtime;
+        if (!sourceStat(objPath, srcSize, srcMtime) || srcSize != h.srcSize) return Result::Stale;
+        if (srcMtime != h.srcMtime) {
+            uint64_t srcHash;
+            if (!hashFile(objPath, srcHash) || srcHash != h.srcHash) return Result::Stale;
+        }
+
+        if (h.pathLen > static_cast<size_t>(r.end - r.p)) return Result::Corrupt;
+        if (std::string(r.p, h.pathLen) != objPath) return Result::Stale; // 다른 경로에서 복사된 캐시
+        r.p += h.pathLen;
+        return Result::Hit;
+    }
+}
+
+MeshCache::Result MeshCache::read(const std::string &objPath, uint32_t flags, ModelLoader &m) {
+    MappedFile f;
+    Header h;
+    Reader r{nullptr, nullptr};
+    if (Result res = openChecked(objPath, flags, f, h, r); res != Result::Hit) return res;
+
+    const char *payload = r.p;
+    if (hashBytes(payload, r.end - payload) != h.payloadHash) return Result::Corrupt;
+
+    // 검증이 끝나기 전에는 model 을 건드리지 않도록 임시로 읽은 뒤 교체
+    std::vector<glm::vec3> rawPos, faceNrm, vertNrm;
+    std::vector<uint32_t> rawIdx, indices, meshletTris, sourceFaces, sourceVertices;
+    std::vector<Vertex> vertices;
+    std::vector<int> faceMatIds;
+    std::vector<tinyobj::material_t> materials;
+    bool ok = r.vec(rawPos, h.rawPos) && r.vec(rawIdx, h.rawIdx)
+              && r.vec(faceNrm, h.faceNrm) && r.vec(vertNrm, h.vertNrm)
+              && r.vec(vertices, h.vertices) && r.vec(indices, h.indices)
+              && r.vec(faceMatIds, h.faceMatIds) && r.vec(meshletTris, h.meshletTris)
+              && r.vec(sourceFaces, h.sourceFaces) && r.vec(sourceVertices, h.sourceVertices)
+              && h.materialBytes == static_cast<uint64_t>(r.end - r.p)
+              && unpackMaterials(r.p, h.materialBytes, materials);
+    if (!ok) return Result::Corrupt;
+
+    m.rawPos_ = std::move(rawPos);
+    m.rawIdx_ = std::move(rawIdx);
+    m.faceNrm_ = std::move(faceNrm);
+    m.vertNrm_ = std::move(vertNrm);
+    m.vertices_ = std::move(vertices);
+    m.indices_ = std::move(indices);
+    m.faceMatIds_ = std::move(faceMatIds);
+    m.meshletTris_ = std::move(meshletTris);
+    m.sourceFaces_ = std::move(sourceFaces);
+    m.sourceVertices_ = std::move(sourceVertices);
+    m.materials_ = std::move(materials);
+    m.center_ = {h.center[0], h.center[1], h.center[2]};
+    m.maxExtent_ = h.maxExtent;
+    return Result::Hit;
+}
+
+MeshCache::Result MeshCache::readUploadData(const std::string &objPath, uint32_t flags, UploadData &out) {
+    MappedFile f;
+    Header h;
+    Reader r{nullptr, nullptr};
+    if (Result res = openChecked(objPath, flags, f, h, r); res != Result::Hit) return res;
+
+    // 앞의 네 섹션은 건너뜀. payload 해시는 보지 않음 (호출하는 쪽이 해제할 때의 내용 해시와 비교)
+    const uint64_t skip = (h.rawPos + h.faceNrm + h.vertNrm) * sizeof(glm::vec3) + h.rawIdx * sizeof(uint32_t);
+    if (h.rawPos > size_t(r.end - r.p) || h.rawIdx > size_t(r.end - r.p) || h.faceNrm > size_t(r.end - r.p) ||
+        h.vertNrm > size_t(r.end - r.p) || skip > static_cast<uint64_t>(r.end - r.p))
+        return Result::Corrupt;
+    r.p += skip;
+    if (!r.vec(out.vertices, h.vertices) || !r.vec(out.indices, h.indices)) {
+        out = UploadData();
+        return Result::Corrupt;
+    }
+    return Result::Hit;
+}
+
+bool MeshCache::write(const std::string &objPath, uint32_t flags, const ModelLoader &m) {
+    Header h{};
+    std::memcpy(h.magic, kMagic, sizeof kMagic);
+    h.version = kVersion;
+    h.flags = flags;
+    if (!sourceStat(objPath, h.srcSize, h.srcMtime) || !hashFile(objPath, h.srcHash))
+        return false;
+
+    const std::string mats = packMaterials(m.materials_);
+    h.pathLen = objPath.size();
+    h.rawPos = m.rawPos_.size();
+    h.rawIdx = m.rawIdx_.size();
+    h.faceNrm = m.faceNrm_.size();
+    h.vertNrm = m.vertNrm_.size();
+    h.vertices = m.vertices_.size();
+    h.indices = m.indices_.size();
+    h.faceMatIds = m.faceMatIds_.size();
+    h.meshletTris = m.meshletTris_.size();
+    h.sourceFaces = m.sourceFaces_.size();
+    h.sourceVertices = m.sourceVertices_.size();
+    h.materialBytes = mats.size();
+    h.center[0] = m.center_.x;
+    h.center[1] = m.center_.y;
+    h.center[2] = m.center_.z;
+    h.maxExtent = m.maxExtent_;
+
+    std::string tmp = cachePath(objPath) + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char *>(&h), sizeof h); // payloadHash 는 뒤에서 채움
+        out.write(objPath.data(), static_cast<std::streamsize>(objPath.size()));
+        auto put = [&](const void *p, size_t n) { out.write(static_cast<const char *>(p), static_cast<std::streamsize>(n)); };
+        put(m.rawPos_.data(), m.rawPos_.size() * sizeof(glm::vec3));
+        put(m.rawIdx_.data(), m.rawIdx_.size() * sizeof(uint32_t));
+        put(m.faceNrm_.data(), m.faceNrm_.size() * sizeof(glm::vec3));
+        put(m.vertNrm_.data(), m.vertNrm_.size() * sizeof(glm::vec3));
+        put(m.vertices_.data(), m.vertices_.size() * sizeof(Vertex));
+        put(m.indices_.data(), m.indices_.size() * sizeof(uint32_t));
+        put(m.faceMatIds_.data(), m.faceMatIds_.size() * sizeof(int));
+        put(m.meshletTris_.data(), m.meshletTris_.size() * sizeof(uint32_t));
+        put(m.sourceFaces_.data(), m.sourceFaces_.size() * sizeof(uint32_t));
+        put(m.sourceVertices_.data(), m.sourceVertices_.size() * sizeof(uint32_t));
+        put(mats.data(), mats.size());
+        if (!out) { out.close(); fs::remove(tmp); return false; }
+    }
+
+    // 방금 쓴 payload 를 mmap 해서 해시 (read 와 같은 경로)
+    {
+        MappedFile f;
+        if (!f.open(tmp)) return false;
+        size_t off = sizeof h + objPath.size();
+        h.payloadHash = hashBytes(f.data() + off, f.size() - off);
+    }
+    {
+        std::fstream out(tmp, std::ios::binary | std::ios::in | std::ios::out);
+        out.write(reinterpret_cast<const char *>(&h), sizeof h);
+        if (!out) { out.close(); fs::remove(tmp); return false; }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp, cachePath(objPath), ec);
+    if (ec) { fs::remove(tmp, ec); return false; }
+    return true;
+}
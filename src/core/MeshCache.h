@@ -0,0 +1,34 @@
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class ModelLoader;
+struct UploadData;
+
+/// OBJ 옆에 두는 바이너리 메쉬 캐시 (<obj>.meshcache).
+/// 원본 경로·크기·mtime·내용 해시를 키로, 로드가 끝난 ModelLoader 배열을 그대로 저장.
+/// 다음 로드에서는 mmap 으로 읽어 텍스트 파싱과 노멀 생성을 통째로 건너뜀
+class MeshCache {
+public:
+    enum class Result { Hit, Missing, Stale, Corrupt };
+
+    static std::string cachePath(const std::string &objPath);
+
+    /// 캐시가 유효하면 model 을 채우고 Hit. 그 외에는 model 을 건드리지 않음
+    static Result read(const std::string &objPath, uint32_t flags, ModelLoader &model);
+
+    /// GPU 업로드용 vertices / indices 두 섹션만 out 에 읽음 (lean 모드 복원용, 나머지 섹션은 읽지 않음).
+    /// 원본 확인은 read() 와 같지만 payload 해시는 보지 않으므로 내용 검증은 호출하는 쪽에서
+    static Result readUploadData(const std::string &objPath, uint32_t flags, UploadData &out);
+
+    /// 임시 파일에 쓴 뒤 rename (쓰다 만 캐시가 남지 않도록)
+    static bool write(const std::string &objPath, uint32_t flags, const ModelLoader &model);
+
+    /// 64‑bit 내용 해시. 1 MB 블록 단위로 병렬 계산 (스레드 수와 무관하게 같은 값)
+    static uint64_t hashBytes(const void *data, size_t size);
+};
+
+#endif //MESHCACHE_H
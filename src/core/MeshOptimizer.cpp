@@ -0,0 +1,368 @@
+#include "MeshOptimizer.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Forsyth 원문 파라미터 (https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html)
+    constexpr int kCacheSize = 32;          // 점수 계산용 LRU 크기
+    constexpr int kMaxValence = 32;         // 이 이상은 같은 점수로 취급
+    constexpr float kLastTriScore = 0.75f;  // 직전 삼각형의 세 정점
+    constexpr float kCacheDecayPower = 1.5f;
+    constexpr float kValenceBoostScale = 2.0f;
+    constexpr float kValenceBoostPower = 0.5f;
+
+    struct ScoreTable {
+        float cache[kCacheSize];
+        float valence[kMaxValence + 1];
+
+        ScoreTable() {
+            for (int i = 0; i < kCacheSize; ++i) {
+                if (i < 3) {
+                    cache[i] = kLastTriScore;
+                } else {
+                    float s = 1.0f - float(i - 3) / float(kCacheSize - 3);
+                    cache[i] = std::pow(s, kCacheDecayPower);
+                }
+            }
+            valence[0] = 0.0f;
+            for (int i = 1; i <= kMaxValence; ++i)
+                valence[i] = kValenceBoostScale * std::pow(float(i), -kValenceBoostPower);
+        }
+
+        /// 남은 삼각형이 없는 정점은 다시 뽑힐 일이 없으므로 -1
+        float vertex(int cachePos, uint32_t remaining) const {
+            if (remaining == 0) return -1.0f;
+            float s = cachePos >= 0 ? cache[cachePos] : 0.0f;
+            return s + valence[std::min<uint32_t>(remaining, kMaxValence)];
+        }
+    };
+
+    /// 10비트 정수 세 개를 비트 단위로 섞음 (x 가 최하위)
+    inline uint32_t spreadBits10(uint32_t v) {
+        v &= 0x3FF;
+        v = (v | (v << 16)) & 0x030000FF;
+        v = (v | (v << 8)) & 0x0300F00F;
+        v = (v | (v << 4)) & 0x030C30C3;
+        v = (v | (v << 2)) & 0x09249249;
+        return v;
+    }
+
+    /// center 중심 extent 정육면체를 1024³ 격자로 나눈 Morton 코드
+    struct MortonGrid {
+        glm::vec3 origin;
+        float scale;
+
+        MortonGrid(const glm::vec3 &center, float extent)
+            : origin(center - glm::vec3(0.5f * extent)),
+              scale(extent > 0.0f ? 1023.0f / extent : 0.0f) {}
+
+        uint32_t code(const glm::vec3 &p) const {
+            glm::vec3 q = (p - origin) * scale;
+            auto cell = [](float f) {
+                return f > 0.0f ? static_cast<uint32_t>(std::min(f + 0.5f, 1023.0f)) : 0u; // NaN 도 0
+            };
+            return spreadBits10(cell(q.x)) | (spreadBits10(cell(q.y)) << 1) | (spreadBits10(cell(q.z)) << 2);
+        }
+    };
+
+    inline const glm::vec3 &at(const glm::vec3 *base, size_t stride, size_t i) {
+        return *reinterpret_cast<const glm::vec3 *>(reinterpret_cast<const char *>(base) + i * stride);
+    }
+
+    /// 구간이 쓰는 정점만 0.. 로 다시 번호 매김 (전체 정점 수 크기의 배열을 구간마다 만들지 않도록).
+    /// used[local] = 원래 정점 번호
+    std::vector<uint32_t> localIndices(const uint32_t *indices, size_t count, std::vector<uint32_t> &used) {
+        std::vector<uint32_t> local(indices, indices + count);
+        used = local;
+        std::sort(used.begin(), used.end());
+        used.erase(std::unique(used.begin(), used.end()), used.end());
+        for (auto &v : local)
+            v = static_cast<uint32_t>(std::lower_bound(used.begin(), used.end(), v) - used.begin());
+        return local;
+    }
+
+    /// 상위 32비트 = 키, 하위 32비트 = 원래 번호 → 정렬 후 하위만 꺼내면 안정 정렬 순서
+    std::vector<uint32_t> orderByKey(std::vector<uint64_t> &keyed) {
+        std::sort(keyed.begin(), keyed.end());
+        std::vector<uint32_t> order(keyed.size());
+        for (size_t i = 0; i < keyed.size(); ++i) order[i] = static_cast<uint32_t>(keyed[i]);
+        return order;
+    }
+}
+
+namespace MeshOptimizer {
+    VertexCacheStats analyzeVertexCache(const uint32_t *indices, size_t indexCount,
+                                        size_t vertexCount, unsigned cacheSize) {
+        VertexCacheStats st;
+        if (indexCount < 3 || vertexCount == 0) return st;
+
+        // 정점이 FIFO 에 들어간 시각을 기록 → 현재 시각과의 차이로 적중 여부 판정
+        std::vector<size_t> stamp(vertexCount, 0);
+        size_t time = cacheSize + 1;
+        size_t misses = 0;
+        for (size_t i = 0; i < indexCount; ++i) {
+            uint32_t v = indices[i];
+            if (time - stamp[v] > cacheSize) {
+                stamp[v] = time++;
+                ++misses;
+            }
+        }
+        st.acmr = float(misses) / float(indexCount / 3);
+        st.atvr = float(misses) / float(vertexCount);
+        return st;
+    }
+
+    VertexFetchStats analyzeVertexFetch(const uint32_t *indices, size_t indexCount,
+                                        size_t vertexCount, size_t vertexSize) {
+        VertexFetchStats st;
+        if (indexCount == 0 || vertexCount == 0 || vertexSize == 0) return st;
+
+        constexpr size_t kLine = 64, kLines = 512;   // 32 KB
+        constexpr unsigned kPostTransform = 16;
+        std::vector<size_t> stamp(vertexCount, 0);
+        size_t time = kPostTransform + 1;
+        std::vector<size_t> tags(kLines, SIZE_MAX);
+        size_t lineMisses = 0;
+        for (size_t i = 0; i < indexCount; ++i) {
+            uint32_t v = indices[i];
+            if (time - stamp[v] <= kPostTransform) continue;  // 변환 결과 재사용 → fetch 없음
+            stamp[v] = time++;
+            size_t first = v * vertexSize / kLine, last = ((v + 1) * vertexSize - 1) / kLine;
+            for (size_t line = first; line <= last; ++line) {
+                size_t &tag = tags[line % kLines];
+                if (tag != line) { tag = line; ++lineMisses; }
+            }
+        }
+        st.bytesFetched = lineMisses * kLine;
+        st.overfetch = float(st.bytesFetched) / float(vertexCount * vertexSize);
+        return st;
+    }
+
+    std::vector<uint32_t> optimizeVertexCache(const uint32_t *indices, size_t indexCount,
+                                              size_t vertexCount) {
+        static const ScoreTable table;
+        const size_t triCount = indexCount / 3;
+
+        // 정점 → 삼각형 인접 리스트 (CSR). 배출된 삼각형은 리스트 뒤로 밀어냄
+        std::vector<uint32_t> remaining(vertexCount, 0);
+        for (size_t i = 0; i < triCount * 3; ++i) ++remaining[indices[i]];
+        std::vector<uint32_t> offset(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; ++v) offset[v + 1] = offset[v] + remaining[v];
+        std::vector<uint32_t> adj(triCount * 3);
+        {
+            std::vector<uint32_t> cursor(offset.begin(), offset.end() - 1);
+            for (size_t i = 0; i < triCount * 3; ++i)
+                adj[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        std::vector<float> vScore(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v) vScore[v] = table.vertex(-1, remaining[v]);
+
+        std::vector<float> tScore(triCount);
+        for (size_t t = 0; t < triCount; ++t) {
+            const uint32_t *tri = indices + 3 * t;
+            tScore[t] = vScore[tri[0]] + vScore[tri[1]] + vScore[tri[2]];
+        }
+        std::vector<char> emitted(triCount, 0);
+
+        std::vector<uint32_t> order;
+        order.reserve(triCount);
+
+        uint32_t cache[kCacheSize + 3];
+        int cacheCount = 0;
+        size_t scan = 0; // 캐시에 후보가 없을 때 다음 미배출 삼각형을 찾는 커서
+
+        // 첫 삼각형은 전체 최고점 (valence 가 낮은 가장자리부터 시작하게 됨)
+        int64_t best = -1;
+        float bestScore = -1.0f;
+        for (size_t t = 0; t < triCount; ++t)
+            if (tScore[t] > bestScore) { bestScore = tScore[t]; best = int64_t(t); }
+
+        while (best >= 0) {
+            const uint32_t bt = static_cast<uint32_t>(best);
+            const uint32_t *tri = indices + 3 * bt;
+            emitted[bt] = 1;
+            order.push_back(bt);
+
+            // 정점별 남은 삼각형 목록에서 제거 (live 구간 끝과 교환)
+            for (int k = 0; k < 3; ++k) {
+                uint32_t v = tri[k];
+                uint32_t *list = &adj[offset[v]];
+                for (uint32_t j = 0; j < remaining[v]; ++j) {
+                    if (list[j] == bt) {
+                        std::swap(list[j], list[remaining[v] - 1]);
+                        --remaining[v];
+                        break;
+                    }
+                }
+            }
+
+            // LRU 갱신: 방금 쓴 정점을 앞에, 나머지는 뒤로 밀림
+            uint32_t next[kCacheSize + 3];
+            int nextCount = 0;
+            for (int k = 0; k < 3; ++k) {
+                uint32_t v = tri[k];
+                if (std::find(next, next + nextCount, v) == next + nextCount) next[nextCount++] = v;
+            }
+            const int fresh = nextCount;
+            for (int i = 0; i < cacheCount; ++i) {
+                uint32_t v = cache[i];
+                if (std::find(next, next + fresh, v) == next + fresh) next[nextCount++] = v;
+            }
+
+            // 캐시 안 정점 (+ 밀려난 정점) 의 점수와 주변 삼각형 점수를 갱신하면서 다음 후보를 고름.
+            // 같은 삼각형이 뒤에서 다시 갱신될 수 있어 근사이지만 별도 탐색 패스보다 2배 빠름
+            best = -1;
+            bestScore = -1.0f;
+            for (int i = 0; i < nextCount; ++i) {
+                uint32_t v = next[i];
+                if (remaining[v] == 0) continue;
+                float s = table.vertex(i < kCacheSize ? i : -1, remaining[v]);
+                float d = s - vScore[v];
+                vScore[v] = s;
+                const uint32_t *list = &adj[offset[v]];
+                for (uint32_t j = 0; j < remaining[v]; ++j) {
+                    uint32_t t = list[j];
+                    float ts = tScore[t] + d;
+                    tScore[t] = ts;
+                    if (ts > bestScore) { bestScore = ts; best = t; }
+                }
+            }
+            cacheCount = std::min(nextCount, kCacheSize);
+            for (int i = 0; i < cacheCount; ++i) cache[i] = next[i];
+
+            // 캐시와 이어진 삼각형이 없으면 아직 남은 삼각형 중 첫 번째
+            if (best < 0) {
+                while (scan < triCount && emitted[scan]) ++scan;
+                if (scan < triCount) best = int64_t(scan);
+            }
+        }
+        return order;
+    }
+
+    std::vector<uint32_t> optimizeVertexCacheClustered(const uint32_t *indices, size_t indexCount,
+                                                       size_t clusterTriangles) {
+        const size_t triCount = indexCount / 3;
+        const size_t clusters = (triCount + clusterTriangles - 1) / clusterTriangles;
+        std::vector<uint32_t> order(triCount);
+        parallel::forEachTask(clusters, [&](size_t c) {
+            const size_t first = c * clusterTriangles;
+            const size_t count = std::min(clusterTriangles, triCount - first);
+
+            std::vector<uint32_t> used;
+            const auto local = localIndices(indices + 3 * first, 3 * count, used);
+            const auto sub = optimizeVertexCache(local.data(), local.size(), used.size());
+            for (size_t k = 0; k < count; ++k)
+                order[first + k] = static_cast<uint32_t>(first + sub[k]);
+        });
+        return order;
+    }
+
+    // 면 노멀과 meshlet 평균 노멀의 cos 이 이보다 작으면 meshlet 을 끊음 (약 37°, 콘이 넓어지는 것 방지)
+    constexpr float kMeshletConeCut = 0.8f;
+
+    std::vector<uint32_t> buildMeshlets(const uint32_t *indices, size_t indexCount,
+                                        const glm::vec3 *positions, size_t stride, size_t blockTriangles,
+                                        size_t maxVertices, size_t maxTriangles) {
+        const size_t triCount = indexCount / 3;
+        const size_t blocks = (triCount + blockTriangles - 1) / blockTriangles;
+        std::vector<std::vector<uint32_t>> counts(blocks);
+
+        parallel::forEachTask(blocks, [&](size_t blk) {
+            const size_t first = blk * blockTriangles;
+            const size_t count = std::min(blockTriangles, triCount - first);
+            std::vector<uint32_t> used;
+            const auto local = localIndices(indices + 3 * first, 3 * count, used);
+
+            std::vector<uint32_t> stamp(used.size(), 0); // == meshletId 이면 지금 meshlet 에 있는 정점
+            uint32_t meshletId = 1, tris = 0, verts = 0;
+            glm::vec3 axis(0.0f);
+            auto &blockCounts = counts[blk];
+
+            // 삼각형 순서는 그대로 두고 경계만 정함: 한도를 넘거나 노멀이 meshlet 평균에서 많이 벗어나면 자름
+            for (size_t t = 0; t < count; ++t) {
+                const uint32_t *tri = &local[3 * t];
+                glm::vec3 p0 = at(positions, stride, used[tri[0]]);
+                glm::vec3 n = glm::cross(at(positions, stride, used[tri[1]]) - p0,
+                                         at(positions, stride, used[tri[2]]) - p0);
+                float len = glm::length(n);
+                n = len > 0.0f ? n / len : glm::vec3(0.0f);
+
+                const uint32_t extra = uint32_t(stamp[tri[0]] != meshletId) +
+                                       uint32_t(stamp[tri[1]] != meshletId && tri[1] != tri[0]) +
+                                       uint32_t(stamp[tri[2]] != meshletId && tri[2] != tri[0] && tri[2] != tri[1]);
+                const float axisLen = glm::length(axis);
+                const bool bends = axisLen > 0.0f && len > 0.0f && glm::dot(axis / axisLen, n) < kMeshletConeCut;
+                if (tris && (verts + extra > maxVertices || tris == maxTriangles || bends)) {
+                    blockCounts.push_back(tris);
+                    ++meshletId;
+                    tris = verts = 0;
+                    axis = glm::vec3(0.0f);
+                }
+                for (int c = 0; c < 3; ++c) {
+                    if (stamp[tri[c]] != meshletId) {
+                        stamp[tri[c]] = meshletId;
+                        ++verts;
+                    }
+                }
+                axis += n;
+                ++tris;
+            }
+            if (tris) blockCounts.push_back(tris);
+        });
+
+        std::vector<uint32_t> out;
+        for (const auto &c : counts) out.insert(out.end(), c.begin(), c.end());
+        return out;
+    }
+
+    std::vector<uint32_t> mortonTriangleOrder(const uint32_t *indices, size_t indexCount,
+                                              const glm::vec3 *positions, size_t stride,
+                                              const glm::vec3 &center, float extent) {
+        const MortonGrid grid(center, extent);
+        std::vector<uint64_t> keyed(indexCount / 3);
+        parallel::forRange(keyed.size(), [&](size_t b, size_t e) {
+            for (size_t t = b; t < e; ++t) {
+                const uint32_t *tri = indices + 3 * t;
+                glm::vec3 c = (at(positions, stride, tri[0]) + at(positions, stride, tri[1]) +
+                               at(positions, stride, tri[2])) * (1.0f / 3.0f);
+                keyed[t] = (uint64_t(grid.code(c)) << 32) | t;
+            }
+        });
+        return orderByKey(keyed);
+    }
+
+    std::vector<uint32_t> firstUseRemap(const uint32_t *indices, size_t indexCount, size_t vertexCount) {
+        constexpr uint32_t kUnset = 0xFFFFFFFFu;
+        std::vector<uint32_t> remap(vertexCount, kUnset);
+        uint32_t next = 0;
+        for (size_t i = 0; i < indexCount; ++i) {
+            uint32_t &r = remap[indices[i]];
+            if (r == kUnset) r = next++;
+        }
+        for (auto &r : remap)
+            if (r == kUnset) r = next++;
+        return remap;
+    }
+
+    std::vector<uint32_t> mortonRemap(const glm::vec3 *positions, size_t vertexCount, size_t stride,
+                                      const glm::vec3 &center, float extent) {
+        const MortonGrid grid(center, extent);
+        std::vector<uint64_t> keyed(vertexCount);
+        parallel::forRange(vertexCount, [&](size_t b, size_t e) {
+            for (size_t v = b; v < e; ++v)
+                keyed[v] = (uint64_t(grid.code(at(positions, stride, v))) << 32) | v;
+        });
+        const std::vector<uint32_t> order = orderByKey(keyed); // order[new] = old
+        std::vector<uint32_t> remap(vertexCount);
+        for (size_t i = 0; i < vertexCount; ++i) remap[order[i]] = static_cast<uint32_t>(i);
+        return remap;
+    }
+
+    void remapIndices(std::vector<uint32_t> &indices, const std::vector<uint32_t> &remap) {
+        parallel::forRange(indices.size(), [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) indices[i] = remap[indices[i]];
+        }, 1 << 16);
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef MESHOPTIMIZER_H
+#define MESHOPTIMIZER_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+/// GPU 친화적인 인덱스 순서를 만드는 메쉬 후처리
+namespace MeshOptimizer {
+    struct VertexCacheStats {
+        float acmr = 0.0f; // 삼각형당 캐시 미스 (0.5 ~ 3, 낮을수록 좋음)
+        float atvr = 0.0f; // 정점당 캐시 미스 (1 이 이상적)
+    };
+
+    struct VertexFetchStats {
+        size_t bytesFetched = 0; // 캐시 라인(64B) 단위로 메모리에서 읽은 양
+        float overfetch = 0.0f;  // bytesFetched / (정점 수 × 정점 크기), 1 이 이상적
+    };
+
+    /// FIFO post‑transform 캐시(cacheSize 개)를 흉내 내서 ACMR / ATVR 계산
+    VertexCacheStats analyzeVertexCache(const uint32_t *indices, size_t indexCount,
+                                        size_t vertexCount, unsigned cacheSize = 16);
+
+    /// post‑transform 캐시(16) 미스 때만 정점을 읽는다고 보고, 32 KB direct‑mapped 캐시로
+    /// 정점 버퍼 fetch 량을 추정 (대역폭 proxy)
+    VertexFetchStats analyzeVertexFetch(const uint32_t *indices, size_t indexCount,
+                                        size_t vertexCount, size_t vertexSize);
+
+    /// Forsyth 의 linear‑speed vertex cache 최적화.
+    /// 새 순서의 k 번째 삼각형이 원래 몇 번째 삼각형인지 (order[k]) 를 돌려줌 →
+    /// 삼각형 단위 배열(면 노멀, material id 등)도 같은 순서로 옮길 수 있음
+    std::vector<uint32_t> optimizeVertexCache(const uint32_t *indices, size_t indexCount,
+                                              size_t vertexCount);
+
+    /// 삼각형을 clusterTriangles 개씩 끊어 각 구간 안에서만 optimizeVertexCache (구간끼리 병렬).
+    /// 구간 경계를 넘지 않으므로 앞서 잡아 둔 공간 순서의 클러스터가 그대로 유지됨
+    std::vector<uint32_t> optimizeVertexCacheClustered(const uint32_t *indices, size_t indexCount,
+                                                       size_t clusterTriangles);
+
+    /// blockTriangles 구간마다 현재 삼각형 순서를 앞에서부터 잘라 정점 maxVertices / 삼각형 maxTriangles 이하의
+    /// meshlet 으로 나눔. 면 노멀이 meshlet 평균에서 많이 벗어나도 끊어서 노멀 콘이 좁게 유지됨.
+    /// 순서는 바꾸지 않으므로 앞선 캐시 최적화가 그대로 남음. 반환: meshlet 마다 삼각형 수 (구간끼리 병렬)
+    std::vector<uint32_t> buildMeshlets(const uint32_t *indices, size_t indexCount,
+                                        const glm::vec3 *positions, size_t stride, size_t blockTriangles,
+                                        size_t maxVertices, size_t maxTriangles);
+
+    /// 삼각형 무게중심의 Morton(Z‑order) 코드 순서. 반환 형식은 optimizeVertexCache 와 같음.
+    /// positions 는 stride 바이트 간격 (Vertex 배열을 그대로 넘길 수 있음), 격자는 center 중심 extent 정육면체
+    std::vector<uint32_t> mortonTriangleOrder(const uint32_t *indices, size_t indexCount,
+                                              const glm::vec3 *positions, size_t stride,
+                                              const glm::vec3 &center, float extent);
+
+    /// 정점 재배치표 remap[old] = new. 인덱스에서 처음 등장하는 순서, 쓰이지 않는 정점은 맨 뒤
+    std::vector<uint32_t> firstUseRemap(const uint32_t *indices, size_t indexCount, size_t vertexCount);
+
+    /// 정점 위치의 Morton 코드 순서로 재배치표 생성 (같은 코드끼리는 원래 순서 유지)
+    std::vector<uint32_t> mortonRemap(const glm::vec3 *positions, size_t vertexCount, size_t stride,
+                                      const glm::vec3 &center, float extent);
+
+    /// 인덱스 값을 remap 으로 치환
+    void remapIndices(std::vector<uint32_t> &indices, const std::vector<uint32_t> &remap);
+
+    /// data[remap[i]] = old data[i]. 크기가 다르면 호출 쪽 버그 (인덱스만 바뀌고 데이터는 그대로 남게 됨)
+    template<class T>
+    void remapVertices(std::vector<T> &data, const std::vector<uint32_t> &remap) {
+        assert(data.size() == remap.size());
+        std::vector<T> out(data.size());
+        for (size_t i = 0; i < remap.size(); ++i) out[remap[i]] = data[i];
+        data.swap(out);
+    }
+
+    /// order 에 따라 삼각형 단위로 재배치 (perTri = 삼각형당 원소 수, 인덱스 버퍼면 3). 크기는 remapVertices 와 같이 맞아야 함
+    template<class T>
+    void permuteTriangles(std::vector<T> &data, const std::vector<uint32_t> &order, size_t perTri = 1) {
+        assert(data.size() == order.size() * perTri);
+        std::vector<T> out(data.size());
+        for (size_t k = 0; k < order.size(); ++k)
+            for (size_t j = 0; j < perTri; ++j)
+                out[k * perTri + j] = data[order[k] * perTri + j];
+        data.swap(out);
+    }
+}
+
+#endif //MESHOPTIMIZER_H
@@ -0,0 +1,282 @@
+#include "MeshSimplifier.h"
+#include "FlatIndexMap.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+    /// 경계 edge 를 따라 세우는 수직 평면의 가중치 (경계가 안쪽으로 말려 들어가지 않도록)
+    constexpr double kBorderWeight = 10.0;
+    constexpr int kMaxPasses = 100;
+
+    enum class Kind : uint8_t {
+        Manifold, // 어디로든 이동 가능
+        Border,   // 경계 edge 를 따라 다른 경계 정점으로만
+        Locked    // 비매니폴드 edge 에 닿음 → 움직이지 않음 (collapse 대상은 가능)
+    };
+
+    /// 대칭 4x4 quadric: 평면까지 거리² 의 면적 가중 합. w 는 누적 가중치 (오차를 거리² 로 정규화)
+    struct Quadric {
+        double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+        double b0 = 0, b1 = 0, b2 = 0;
+        double c = 0;
+        double w = 0;
+
+        void addPlane(double nx, double ny, double nz, double d, double weight) {
+            a00 += weight * nx * nx; a01 += weight * nx * ny; a02 += weight * nx * nz;
+            a11 += weight * ny * ny; a12 += weight * ny * nz; a22 += weight * nz * nz;
+            b0 += weight * nx * d; b1 += weight * ny * d; b2 += weight * nz * d;
+            c += weight * d * d;
+            w += weight;
+        }
+
+        Quadric &operator+=(const Quadric &o) {
+            a00 += o.a00; a01 += o.a01; a02 += o.a02; a11 += o.a11; a12 += o.a12; a22 += o.a22;
+            b0 += o.b0; b1 += o.b1; b2 += o.b2;
+            c += o.c;
+            w += o.w;
+            return *this;
+        }
+
+        /// 두 quadric 합을 p 에서 평가한 거리² (따로 합쳐 두지 않고 바로 계산)
+        static double eval(const Quadric &q, const Quadric &r, const glm::vec3 &p) {
+            double x = p.x, y = p.y, z = p.z;
+            double e = x * x * (q.a00 + r.a00) + y * y * (q.a11 + r.a11) + z * z * (q.a22 + r.a22)
+                       + 2.0 * (x * y * (q.a01 + r.a01) + x * z * (q.a02 + r.a02) + y * z * (q.a12 + r.a12))
+                       + 2.0 * (x * (q.b0 + r.b0) + y * (q.b1 + r.b1) + z * (q.b2 + r.b2))
+                       + (q.c + r.c);
+            double w = q.w + r.w;
+            return std::max(0.0, w > 0.0 ? e / w : e);
+        }
+    };
+
+    struct PosHash {
+        uint64_t operator()(const glm::vec3 &p) const {
+            uint32_t u[3];
+            std::memcpy(u, &p, sizeof(u));
+            return hashMix64((uint64_t(u[0]) | (uint64_t(u[1]) << 32)) ^ hashMix64(u[2]));
+        }
+    };
+
+    struct PosEqual {
+        bool operator()(const glm::vec3 &a, const glm::vec3 &b) const {
+            return std::memcmp(&a, &b, sizeof(glm::vec3)) == 0;
+        }
+    };
+
+    /// 정점 → 삼각형 인접 리스트 (CSR)
+    struct Adjacency {
+        std::vector<uint32_t> offset, tris;
+
+        void build(const std::vector<uint32_t> &idx, size_t vertexCount) {
+            parallel::groupByKey(idx.data(), idx.size(), vertexCount, offset, tris,
+                                 [](size_t i) { return static_cast<uint32_t>(i / 3); });
+        }
+
+        const uint32_t *begin(uint32_t v) const { return tris.data() + offset[v]; }
+        const uint32_t *end(uint32_t v) const { return tris.data() + offset[v + 1]; }
+    };
+
+    inline bool hasVertex(const uint32_t *tri, uint32_t v) {
+        return tri[0] == v || tri[1] == v || tri[2] == v;
+    }
+
+    /// a, b 를 모두 가진 삼각형 수 (1 = 경계 edge, 3 이상 = 비매니폴드)
+    inline int sharedTriangles(const Adjacency &adj, const std::vector<uint32_t> &idx, uint32_t a, uint32_t b) {
+        int n = 0;
+        for (const uint32_t *t = adj.begin(a); t != adj.end(a); ++t)
+            n += hasVertex(&idx[3 * *t], b);
+        return n;
+    }
+}
+
+namespace MeshSimplifier {
+    bool simplify(const uint32_t *indices, size_t indexCount,
+                  const glm::vec3 *positions, size_t stride, size_t vertexCount,
+                  size_t targetIndexCount, Result &out,
+                  const std::atomic<bool> *cancel) {
+        auto cancelled = [cancel] { return cancel && cancel->load(std::memory_order_relaxed); };
+        auto at = [&](size_t i) -> const glm::vec3 & {
+            return *reinterpret_cast<const glm::vec3 *>(reinterpret_cast<const char *>(positions) + i * stride);
+        };
+        out.indices.clear();
+        out.error = 0.0f;
+
+        // 1) 위치가 같은 정점을 하나로 (welded id). 결과는 처음 등장한 원래 정점으로 되돌림
+        std::vector<uint32_t> weld(vertexCount);
+        std::vector<glm::vec3> pos;
+        std::vector<uint32_t> back;
+        pos.reserve(vertexCount);
+        back.reserve(vertexCount);
+        {
+            FlatIndexMap<glm::vec3, PosHash, PosEqual> map(vertexCount);
+            for (size_t v = 0; v < vertexCount; ++v) {
+                uint32_t id = map.findOrInsert(at(v), static_cast<uint32_t>(pos.size()), pos.data());
+                if (id == pos.size()) {
+                    pos.push_back(at(v));
+                    back.push_back(static_cast<uint32_t>(v));
+                }
+                weld[v] = id;
+            }
+        }
+        const size_t W = pos.size();
+
+        std::vector<uint32_t> idx;
+        idx.reserve(indexCount);
+        for (size_t i = 0; i + 2 < indexCount; i += 3) {
+            uint32_t a = weld[indices[i]], b = weld[indices[i + 1]], c = weld[indices[i + 2]];
+            if (a == b || b == c || a == c) continue;
+            idx.insert(idx.end(), {a, b, c});
+        }
+
+        Adjacency adj;
+        adj.build(idx, W);
+
+        // 2) 정점별 quadric = 주변 삼각형 평면들의 합 (정점마다 gather → 병렬, 결과는 스레드 수와 무관)
+        std::vector<Quadric> quadric(W);
+        std::vector<Kind> kind(W, Kind::Manifold);
+        parallel::forRange(W, [&](size_t b, size_t e) {
+            for (size_t v = b; v < e; ++v) {
+                Quadric &q = quadric[v];
+                for (const uint32_t *t = adj.begin(v); t != adj.end(v); ++t) {
+                    const uint32_t *tri = &idx[3 * *t];
+                    glm::vec3 p0 = pos[tri[0]], p1 = pos[tri[1]], p2 = pos[tri[2]];
+                    glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+                    double len = std::sqrt(double(n.x) * n.x + double(n.y) * n.y + double(n.z) * n.z);
+                    if (len == 0.0) continue;
+                    double nx = n.x / len, ny = n.y / len, nz = n.z / len;
+                    q.addPlane(nx, ny, nz, -(nx * p0.x + ny * p0.y + nz * p0.z), 0.5 * len);
+
+                    // v 에서 나가는 두 edge 중 경계인 것은 수직 평면을 추가로 (반대쪽 끝점은 자기 차례에 추가)
+                    for (int k = 0; k < 3; ++k) {
+                        uint32_t a = tri[k], o = tri[(k + 1) % 3];
+                        if (a != v && o != v) continue;
+                        uint32_t other = (a == v) ? o : a;
+                        int shared = sharedTriangles(adj, idx, uint32_t(v), other);
+                        if (shared > 2) { kind[v] = Kind::Locked; continue; }
+                        if (shared != 1) continue;
+                        if (kind[v] == Kind::Manifold) kind[v] = Kind::Border;
+
+                        glm::vec3 edge = pos[o] - pos[a];
+                        glm::vec3 bn = glm::cross(edge, n);
+                        double bl = std::sqrt(double(bn.x) * bn.x + double(bn.y) * bn.y + double(bn.z) * bn.z);
+                        if (bl == 0.0) continue;
+                        double bx = bn.x / bl, by = bn.y / bl, bz = bn.z / bl;
+                        double el2 = double(edge.x) * edge.x + double(edge.y) * edge.y + double(edge.z) * edge.z;
+                        q.addPlane(bx, by, bz, -(bx * pos[a].x + by * pos[a].y + bz * pos[a].z),
+                                   kBorderWeight * el2);
+                    }
+                }
+            }
+        });
+
+        struct Collapse {
+            double cost;
+            uint32_t from, to;
+        };
+        constexpr double kNever = std::numeric_limits<double>::infinity();
+
+        auto canMove = [&](uint32_t from, uint32_t to) {
+            switch (kind[from]) {
+                case Kind::Manifold: return true;
+                case Kind::Border: return kind[to] == Kind::Border && sharedTriangles(adj, idx, from, to) == 1;
+                case Kind::Locked: break;
+            }
+            return false;
+        };
+
+        // from 을 to 위치로 옮겼을 때 남는 삼각형이 뒤집히는지
+        auto flips = [&](uint32_t from, uint32_t to) {
+            const glm::vec3 &target = pos[to];
+            for (const uint32_t *t = adj.begin(from); t != adj.end(from); ++t) {
+                const uint32_t *tri = &idx[3 * *t];
+                if (hasVertex(tri, to)) continue; // 이 삼각형은 사라짐
+                glm::vec3 p[3], q[3];
+                for (int k = 0; k < 3; ++k) {
+                    p[k] = pos[tri[k]];
+                    q[k] = tri[k] == from ? target : p[k];
+                }
+                glm::vec3 n0 = glm::cross(p[1] - p[0], p[2] - p[0]);
+                glm::vec3 n1 = glm::cross(q[1] - q[0], q[2] - q[0]);
+                if (glm::dot(n0, n1) <= 0.0f) return true;
+            }
+            return false;
+        };
+
+        const size_t targetTris = targetIndexCount / 3;
+        double maxCost = 0.0;
+        std::vector<Collapse> cand;
+        std::vector<uint8_t> touched;
+        std::vector<uint32_t> collapseTo(W);
+
+        // 3) 패스마다 비용이 낮은 collapse 를 서로 겹치지 않게 골라 한꺼번에 적용
+        for (int pass = 0; pass < kMaxPasses && idx.size() / 3 > targetTris; ++pass) {
+            if (cancelled()) return false;
+            if (pass > 0) adj.build(idx, W);
+            const size_t triCount = idx.size() / 3;
+
+            cand.resize(idx.size());
+            parallel::forRange(triCount, [&](size_t b, size_t e) {
+                for (size_t t = b; t < e; ++t) {
+                    for (int k = 0; k < 3; ++k) {
+                        uint32_t a = idx[3 * t + k], o = idx[3 * t + (k + 1) % 3];
+                        double ab = canMove(a, o) ? Quadric::eval(quadric[a], quadric[o], pos[o]) : kNever;
+                        double ba = canMove(o, a) ? Quadric::eval(quadric[a], quadric[o], pos[a]) : kNever;
+                        cand[3 * t + k] = ab <= ba ? Collapse{ab, a, o} : Collapse{ba, o, a};
+                    }
+                }
+            });
+            cand.erase(std::remove_if(cand.begin(), cand.end(),
+                                      [&](const Collapse &c) { return c.cost == kNever; }), cand.end());
+            if (cand.empty()) break;
+
+            // collapse 하나가 삼각형 ~2 개를 없앰. 한 패스는 싼 후보 chunk 개 안에서만 고르고
+            // (비싼 collapse 는 다음 패스에서 다시 평가), 그 안에서 하나도 못 고른 경우에만 더 내려감.
+            // 전체를 정렬하지 않고 필요한 구간만 정렬
+            const size_t needed = (triCount - targetTris) / 2 + 1;
+            auto byCost = [](const Collapse &x, const Collapse &y) { return x.cost < y.cost; };
+            const size_t chunk = std::max(needed * 4, cand.size() / 8);
+            size_t sorted = 0;
+
+            touched.assign(W, 0);
+            for (size_t v = 0; v < W; ++v) collapseTo[v] = static_cast<uint32_t>(v);
+            size_t applied = 0;
+            for (size_t i = 0; i < cand.size() && applied < needed && (i < chunk || applied == 0); ++i) {
+                if (i == sorted) {
+                    sorted = std::min(cand.size(), sorted + chunk);
+                    std::nth_element(cand.begin() + i, cand.begin() + (sorted - 1), cand.end(), byCost);
+                    std::sort(cand.begin() + i, cand.begin() + sorted, byCost);
+                }
+                const Collapse &c = cand[i];
+                if (touched[c.from] || touched[c.to]) continue;
+                if (flips(c.from, c.to)) continue;
+
+                collapseTo[c.from] = c.to;
+                quadric[c.to] += quadric[c.from];
+                maxCost = std::max(maxCost, c.cost);
+                ++applied;
+
+                // from 의 1‑ring 전체를 이번 패스에서 고정 → 위에서 한 뒤집힘 검사가 계속 유효
+                touched[c.to] = 1;
+                for (const uint32_t *t = adj.begin(c.from); t != adj.end(c.from); ++t)
+                    for (int k = 0; k < 3; ++k) touched[idx[3 * *t + k]] = 1;
+            }
+            if (applied == 0) break;
+
+            size_t w = 0;
+            for (size_t t = 0; t < triCount; ++t) {
+                uint32_t a = collapseTo[idx[3 * t]], b = collapseTo[idx[3 * t + 1]], c = collapseTo[idx[3 * t + 2]];
+                if (a == b || b == c || a == c) continue;
+                idx[w++] = a; idx[w++] = b; idx[w++] = c;
+            }
+            idx.resize(w);
+        }
+
+        out.indices.resize(idx.size());
+        for (size_t i = 0; i < idx.size(); ++i) out.indices[i] = back[idx[i]];
+        out.error = static_cast<float>(std::sqrt(maxCost));
+        return true;
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef MESHSIMPLIFIER_H
+#define MESHSIMPLIFIER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+/// Quadric error metric 기반 edge collapse 단순화.
+/// 정점은 기존 정점 중 하나로만 합쳐지므로 결과 인덱스는 원래 정점 버퍼를 그대로 참조 (LOD 끼리 VBO 공유)
+namespace MeshSimplifier {
+    struct Result {
+        std::vector<uint32_t> indices;
+        float error = 0.0f; // 적용된 collapse 중 최대 오차 (모델 좌표 거리, 면적 가중 RMS)
+    };
+
+    /// indexCount 를 targetIndexCount 이하로 줄이려고 시도 (경계·비매니폴드 정점은 보존하므로 못 미칠 수 있음).
+    /// 위치가 비트 단위로 같은 정점은 하나로 보고 처리 (노멀만 다른 중복 정점 때문에 구멍이 생기지 않도록).
+    /// positions 는 stride 바이트 간격. cancel 이 켜지면 false
+    bool simplify(const uint32_t *indices, size_t indexCount,
+                  const glm::vec3 *positions, size_t stride, size_t vertexCount,
+                  size_t targetIndexCount, Result &out,
+                  const std::atomic<bool> *cancel = nullptr);
+}
+
+#endif //MESHSIMPLIFIER_H
@@ -1,141 +1,589 @@
 #define TINYOBJLOADER_IMPLEMENTATION
 
 #include "ModelLoader.h"
+#include "GeometryKernels.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ObjParser.h"
+#include "Parallel.h"
+#include "ProcessMemory.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
 #include <iostream>
-#include <unordered_map>
-
-bool ModelLoader::load(const std::string &filename, bool triangulate) {
-    // attrib : 전체 vertex/normal/texcoord 배열이 저장됨.
-    tinyobj::attrib_t attrib;
-    // shapes : 각각의 mesh(face 그룹) 데이터가 들어 있음.
-    std::vector<tinyobj::shape_t> shapes;
-    std::string warn, err;
-
-    tinyobj::ObjReaderConfig cfg;
-    // quad , polygon 을 삼각형으로 변환할 지 여부
-    cfg.triangulate = triangulate;
-    cfg.mtl_search_path = ""; // .mtl 동일 디렉토리
-
-    // Parse
-    tinyobj::ObjReader reader;
-    if (!reader.ParseFromFile(filename, cfg)) {
-        std::cerr << "TinyObjReader: " << reader.Error() << "\n";
-        return false;
+#include <map>
+#include <numeric>
+
+namespace {
+    /// 파서가 넘겨준 삼각형을 면노멀을 가진 triangle soup 로 바꿔 ctl.onBatch 로 전달.
+    /// previewBudget 을 넘으면 더 이상 보내지 않음 (미리보기 GPU 메모리 상한)
+    ObjParser::Preview makePreview(LoadControl &ctl) {
+        return [&ctl, sent = size_t(0)](const std::vector<glm::vec3> &corners,
+                                         const glm::vec3 &bmin, const glm::vec3 &bmax) mutable {
+            size_t n = std::min(corners.size() / 3, ctl.previewBudget - sent);
+            MeshBatch batch;
+            batch.bboxMin = bmin;
+            batch.bboxMax = bmax;
+            batch.vertices.reserve(3 * n);
+            for (size_t t = 0; t < n; ++t) {
+                const glm::vec3 *p = &corners[3 * t];
+                glm::vec3 nrm = glm::normalize(glm::cross(p[1] - p[0], p[2] - p[0]));
+                for (int k = 0; k < 3; ++k)
+                    batch.vertices.push_back({p[k], nrm, {}});
+            }
+            sent += n;
+            ctl.onBatch(std::move(batch));
+            return sent < ctl.previewBudget;
+        };
     }
-    warn = reader.Warning();
-    if (!warn.empty()) std::cerr << "[tinyobj warn] " << warn << "\n";
 
-    attrib = reader.GetAttrib();
-    shapes = reader.GetShapes();
-    materials_ = reader.GetMaterials();
+    template<class T>
+    size_t capacityBytes(const std::vector<T> &v) { return v.capacity() * sizeof(T); }
 
-    rawPos_.clear();
-    rawIdx_.clear();
-    faceNrm_.clear();
+    /// GPU 에 올라가는 두 배열의 내용 해시 (lean 모드 복원 검증용)
+    uint64_t uploadHash(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices) {
+        return MeshCache::hashBytes(vertices.data(), vertices.size() * sizeof(Vertex)) ^
+               MeshCache::hashBytes(indices.data(), indices.size() * sizeof(uint32_t)) * 0x9E3779B97F4A7C15ULL;
+    }
 
-    size_t vertexCount = attrib.vertices.size() / 3;
-    rawPos_.reserve(vertexCount);
-    vertNrm_.assign(vertexCount, glm::vec3(0.0f));   // 평균노멀 누적용
+    /// m 의 인덱스 구간으로 경계 구와 노멀 콘 계산
+    void computeMeshletBounds(const std::vector<Vertex> &verts, const uint32_t *idx, Meshlet &m) {
+        const size_t first = m.firstIndex, count = m.indexCount;
 
-    vertices_.clear();
-    indices_.clear();
-    faceMatIds_.clear();
+        glm::vec3 mn(1e9f), mx(-1e9f), axis(0.0f);
+        for (size_t i = first; i < first + count; i += 3) {
+            const glm::vec3 &p0 = verts[idx[i]].position, &p1 = verts[idx[i + 1]].position,
+                            &p2 = verts[idx[i + 2]].position;
+            mn = glm::min(mn, glm::min(p0, glm::min(p1, p2)));
+            mx = glm::max(mx, glm::max(p0, glm::max(p1, p2)));
+            glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+            float len = glm::length(n);
+            if (len > 0.0f) axis += n / len;
+        }
+        m.center = (mn + mx) * 0.5f;
+        for (size_t i = first; i < first + count; ++i)
+            m.radius = std::max(m.radius, glm::length(verts[idx[i]].position - m.center));
+
+        float axisLen = glm::length(axis);
+        if (!(axisLen > 0.0f)) return; // 노멀이 서로 상쇄 → 컬링 안 함
+        m.coneAxis = axis / axisLen;
 
-    // rawPos_ 채우기
-    for (size_t i = 0; i < vertexCount; ++i) {
-        glm::vec3 p(attrib.vertices[3*i+0],
-                    attrib.vertices[3*i+1],
-                    attrib.vertices[3*i+2]);
-        rawPos_.push_back(p);
-    }
-
-    // 삼각형 루프: 인덱스,면노멀,버텍스노멀 누적
-    for (const auto& shape : shapes) {
-        size_t index_offset = 0;
-        for (size_t f = 0; f < shape.mesh.num_face_vertices.size(); ++f) {
-            int fv = shape.mesh.num_face_vertices[f];   // triangulate=true → 3
-            tinyobj::index_t idx0 = shape.mesh.indices[index_offset+0];
-            tinyobj::index_t idx1 = shape.mesh.indices[index_offset+1];
-            tinyobj::index_t idx2 = shape.mesh.indices[index_offset+2];
-
-            // 인덱스 배열
-            rawIdx_.push_back(idx0.vertex_index);
-            rawIdx_.push_back(idx1.vertex_index);
-            rawIdx_.push_back(idx2.vertex_index);
-
-            // 면 노멀
-            glm::vec3 p0 = rawPos_[idx0.vertex_index];
-            glm::vec3 p1 = rawPos_[idx1.vertex_index];
-            glm::vec3 p2 = rawPos_[idx2.vertex_index];
-            glm::vec3 faceN = glm::normalize(glm::cross(p1-p0, p2-p0));
-            faceNrm_.push_back(faceN);
-
-            // 버텍스 노멀 누적
-            auto accumulate = [&](tinyobj::index_t idx){
-                if (idx.normal_index >= 0) {
-                    vertNrm_[idx.vertex_index] += glm::vec3(
-                        attrib.normals[3*idx.normal_index+0],
-                        attrib.normals[3*idx.normal_index+1],
-                        attrib.normals[3*idx.normal_index+2]);
-                } else {
-                    vertNrm_[idx.vertex_index] += faceN;   // 노멀 없으면 면노멀
-                }
-            };
-            accumulate(idx0); accumulate(idx1); accumulate(idx2);
-
-            index_offset += fv;
+        // 콘 반각 = 축과 가장 많이 벌어진 면 노멀까지 각도. 90° 이상이면 어느 방향에서든 앞면이 보일 수 있음
+        float minDot = 1.0f;
+        for (size_t i = first; i < first + count; i += 3) {
+            const glm::vec3 &p0 = verts[idx[i]].position, &p1 = verts[idx[i + 1]].position,
+                            &p2 = verts[idx[i + 2]].position;
+            glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+            float len = glm::length(n);
+            if (len > 0.0f) minDot = std::min(minDot, glm::dot(m.coneAxis, n / len));
         }
+        if (minDot > 0.0f)
+            m.coneCutoff = std::sqrt(std::max(0.0f, 1.0f - minDot * minDot));
     }
+}
 
-    // 버텍스 평균노멀 정규화
-    for (auto& n : vertNrm_) n = glm::normalize(n);
+bool ModelLoader::load(const std::string &filename, bool triangulate, LoadControl *ctl) {
+    auto report = [ctl](float f, const char *stage) {
+        if (ctl && ctl->onProgress) ctl->onProgress(f, stage);
+    };
+    auto cancelled = [ctl] { return ctl && ctl->cancel.load(std::memory_order_relaxed); };
 
-    rebuildVertices();
+    // 단계 시간: lap(x) 는 직전 lap 이후 경과 시간을 x 에 기록
+    timings_ = LoadTimings();
+    orderStats_ = MeshOrderStats();
+    const auto start = std::chrono::steady_clock::now();
+    auto mark = start;
+    auto lap = [&mark](double &slot) {
+        auto now = std::chrono::steady_clock::now();
+        slot = std::chrono::duration<double, std::milli>(now - mark).count();
+        mark = now;
+    };
+    auto finish = [&] {
+        timings_.total = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        loadMemory_.rssPeak = procmem::peakRss();
+        loadMemory_.rssAfter = procmem::currentRss();
+    };
+    filename_ = filename;
+    triangulate_ = triangulate;
+    released_ = false;
+    loadMemory_ = LoadMemory();
+    loadMemory_.peakIsLocal = procmem::resetPeak();
+    loadMemory_.rssBefore = procmem::currentRss();
+
+    const uint32_t cacheFlags = cacheKey(triangulate);
+    fromCache_ = false;
+    if (useCache_) {
+        report(0.0f, "Reading cache");
+        switch (MeshCache::read(filename, cacheFlags, *this)) {
+            case MeshCache::Result::Hit:
+                fromCache_ = true;
+                lap(timings_.cacheRead);
+                buildClusters();
+                lap(timings_.clusters);
+                finish();
+                report(1.0f, "Done");
+                return true;
+            case MeshCache::Result::Stale:
+                std::cerr << "[MeshCache] stale cache for " << filename << ", rebuilding\n";
+                break;
+            case MeshCache::Result::Corrupt:
+                std::cerr << "[MeshCache] corrupt cache for " << filename << ", rebuilding\n";
+                break;
+            case MeshCache::Result::Missing:
+                break;
+        }
+        lap(timings_.cacheRead);
+    }
+
+    // 파일을 mmap 해서 바이트를 바로 토큰화 (중간 std::string / attrib 복사 없음)
+    ObjData obj;
+    {
+        MappedFile file;
+        if (!file.open(filename)) {
+            std::cerr << "ModelLoader: cannot open " << filename << "\n";
+            return false;
+        }
+        // 파싱이 전체 진행률의 70% 를 차지한다고 보고 바이트 단위로 보고
+        std::atomic<size_t> parsed{0};
+        const size_t total = std::max<size_t>(file.size(), 1);
+        ObjParser::Progress progress = [&](size_t bytes) {
+            size_t done = parsed.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            report(0.7f * static_cast<float>(done) / static_cast<float>(total), "Parsing");
+            return !cancelled();
+        };
+
+        std::string err;
+        auto t0 = std::chrono::steady_clock::now();
+        report(0.0f, "Parsing");
+        ObjParser::Options opt;
+        opt.triangulate = triangulate;
+        opt.threads = parseThreads_;
+        opt.progress = progress;
+        if (ctl && ctl->onBatch && file.size() >= kPreviewMinBytes)
+            opt.preview = makePreview(*ctl);
+        if (!ObjParser::parse(file.data(), file.data() + file.size(), obj, err, opt)) {
+            if (!cancelled()) std::cerr << "ObjParser: " << filename << ": " << err << "\n";
+            return false;
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        double mb = file.size() / (1024.0 * 1024.0);
+        unsigned threads = file.size() < ObjParser::kParallelThreshold ? 1
+                           : parseThreads_ ? parseThreads_ : parallel::threadCount();
+        std::cerr << "[ModelLoader] parsed " << mb << " MB in " << ms << " ms ("
+                  << (ms > 0 ? mb * 1000.0 / ms : 0.0) << " MB/s, " << threads << " threads)\n";
+    }
+    lap(timings_.parse);
+    loadMemory_.parser = capacityBytes(obj.positions) + capacityBytes(obj.normals) + capacityBytes(obj.posIdx) +
+                         capacityBytes(obj.nrmIdx) + capacityBytes(obj.faceMatIds) + capacityBytes(obj.faceIds);
 
-    // AABB Bounding box 계산
+    if (cancelled()) return false;
+    report(0.7f, "Computing normals");
+    loadMaterials(filename, obj);
+
+    // 파서 결과를 그대로 넘겨받음 (move → 추가 복사 없음)
+    rawPos_ = std::move(obj.positions);
+    rawIdx_ = std::move(obj.posIdx);
+    sourceFaces_ = std::move(obj.faceIds);
+    sourceVertices_.resize(rawPos_.size());
+    std::iota(sourceVertices_.begin(), sourceVertices_.end(), 0u);
+    vertices_.clear();
+    indices_.clear();
+    clusters_.clear();
+    meshletTris_.clear();
+    lods_ = LodChain();
+
+    // SIMD 커널용 위치 SoA 사본 (노멀과 bbox 계산이 끝나면 바로 해제)
+    geom::SoA3 pos;
+    geom::toSoA(rawPos_.data(), rawPos_.size(), pos);
+    computeNormals(obj, pos);
+    obj = ObjData(); // 코너별 vn 인덱스 등 임시 배열은 여기서 해제 (peak 메모리 감소)
+
+    // AABB Bounding box 계산 (블록별 부분 결과를 모아서 합침)
+    const size_t blocks = std::clamp<size_t>(pos.size() >> 16, 1, parallel::threadCount());
+    std::vector<glm::vec3> mins(blocks, glm::vec3(1e9)), maxs(blocks, glm::vec3(-1e9));
+    parallel::forEachTask(blocks, [&](size_t t) {
+        geom::bounds(pos, pos.size() * t / blocks, pos.size() * (t + 1) / blocks, mins[t], maxs[t]);
+    });
     glm::vec3 bboxMin(1e9), bboxMax(-1e9);
-    for (auto& p : rawPos_) {
-        bboxMin = glm::min(bboxMin, p);
-        bboxMax = glm::max(bboxMax, p);
+    for (size_t t = 0; t < blocks; ++t) {
+        bboxMin = glm::min(bboxMin, mins[t]);
+        bboxMax = glm::max(bboxMax, maxs[t]);
     }
+    pos.clear();
 
     center_ = (bboxMin + bboxMax) * 0.5f;
     glm::vec3 diff = bboxMax - bboxMin;
     maxExtent_ = std::max({diff.x, diff.y, diff.z});
+    lap(timings_.normals);
+    if (cancelled()) return false;
+
+    report(0.85f, "Building vertices");
+    rebuildVertices();
+    lap(timings_.vertices);
+    if (cancelled()) return false;
+    if (uploadOnly_) {
+        // 복원에는 vertices_ / indices_ 만 필요 → 나머지는 순서 최적화 전에 해제 (재배치도 건너뜀)
+        std::vector<glm::vec3>().swap(rawPos_);
+        std::vector<uint32_t>().swap(rawIdx_);
+        std::vector<glm::vec3>().swap(faceNrm_);
+        std::vector<glm::vec3>().swap(vertNrm_);
+        std::vector<int>().swap(faceMatIds_);
+        std::vector<uint32_t>().swap(sourceFaces_);
+        std::vector<uint32_t>().swap(sourceVertices_);
+    }
+    if (!vertices_.empty()) {
+        report(0.9f, "Optimizing mesh order");
+        optimizeMeshOrder();
+        lap(timings_.optimize);
+        if (!uploadOnly_) buildClusters();
+        lap(timings_.clusters);
+    }
+
+    if (cancelled()) return false;
+    report(0.95f, "Writing cache");
+    if (useCache_ && !MeshCache::write(filename, cacheFlags, *this))
+        std::cerr << "[MeshCache] could not write " << MeshCache::cachePath(filename) << "\n";
+    lap(timings_.cacheWrite);
+    finish();
+    report(1.0f, "Done");
+
+    return true;
+}
+
+std::vector<MemoryEntry> ModelLoader::memoryUsage() const {
+    return {
+        {"raw_positions", capacityBytes(rawPos_)},
+        {"raw_indices", capacityBytes(rawIdx_)},
+        {"face_normals", capacityBytes(faceNrm_)},
+        {"vertex_normals", capacityBytes(vertNrm_)},
+        {"vertices", capacityBytes(vertices_)},
+        {"indices", capacityBytes(indices_)},
+        {"material_ids", capacityBytes(faceMatIds_)},
+        {"source_ids", capacityBytes(sourceFaces_) + capacityBytes(sourceVertices_)},
+        {"clusters", capacityBytes(clusters_) + capacityBytes(meshlets_) + capacityBytes(meshletTris_)},
+        {"lods", capacityBytes(lods_.indices) + capacityBytes(lods_.levels)},
+        {"materials", capacityBytes(materials_)}, // material_t 안의 문자열 / map 은 제외
+    };
+}
+
+size_t ModelLoader::memoryBytes() const {
+    size_t total = 0;
+    for (const MemoryEntry &e : memoryUsage()) total += e.bytes;
+    return total;
+}
+
+void ModelLoader::releaseUploadData() {
+    if (released_) return;
+    releasedVertices_ = vertices_.size();
+    releasedIndices_ = indices_.size();
+    releasedHash_ = uploadHash(vertices_, indices_);
+    // clear() 는 capacity 를 남기므로 빈 벡터와 교환
+    std::vector<Vertex>().swap(vertices_);
+    std::vector<uint32_t>().swap(indices_);
+    std::vector<glm::vec3>().swap(faceNrm_);
+    std::vector<glm::vec3>().swap(vertNrm_);
+    released_ = true;
+}
+
+uint32_t ModelLoader::cacheKey(bool triangulate) const {
+    return (triangulate ? 1u : 0u) | (optimizeOrder_ ? 2u : 0u) | (order_ == MeshOrder::Morton ? 4u : 0u);
+}
+
+bool ModelLoader::reloadUploadData(UploadData &out, LoadControl *ctl) const {
+    if (!released_) return false;
+    auto matches = [this](const UploadData &d) {
+        return d.vertices.size() == releasedVertices_ && d.indices.size() == releasedIndices_ &&
+               uploadHash(d.vertices, d.indices) == releasedHash_;
+    };
+
+    // 1) .meshcache 에서 두 배열만 (다른 섹션 / 클러스터 / LOD 는 건드리지 않음)
+    if (useCache_ && MeshCache::readUploadData(filename_, cacheKey(triangulate_), out) == MeshCache::Result::Hit) {
+        if (matches(out)) return true;
+        out = UploadData();
+    }
+    if (ctl && ctl->cancel.load(std::memory_order_relaxed)) return false;
 
+    // 2) 캐시가 없거나 안 맞으면 OBJ 를 다시 읽되 vertices_ / indices_ 까지만 만듦 (캐시 읽기·쓰기, 클러스터 없음)
+    ModelLoader fresh;
+    fresh.setUseCache(false);
+    fresh.setOptimizeIndexOrder(optimizeOrder_);
+    fresh.setMeshOrder(order_);
+    fresh.setParseThreads(parseThreads_);
+    fresh.uploadOnly_ = true;
+    if (!fresh.load(filename_, triangulate_, ctl)) return false;
+    out.vertices = std::move(fresh.vertices_);
+    out.indices = std::move(fresh.indices_);
+    if (!matches(out)) {
+        std::cerr << "ModelLoader: " << filename_ << " changed since it was loaded, cannot restore\n";
+        out = UploadData();
+        return false;
+    }
     return true;
 }
 
+void ModelLoader::restoreUploadData(UploadData &&data) {
+    vertices_ = std::move(data.vertices);
+    indices_ = std::move(data.indices);
+    released_ = false;
+}
+
+void ModelLoader::computeNormals(const ObjData &obj, const geom::SoA3 &pos)
+{
+    const size_t triCount = rawIdx_.size() / 3;
+    const size_t vertexCount = rawPos_.size();
+
+    // 1) 면 노멀 – 삼각형마다 독립이라 그대로 병렬 (SIMD 커널)
+    faceNrm_.resize(triCount);
+    parallel::forRange(triCount, [&](size_t b, size_t e) {
+        geom::faceNormals(pos, rawIdx_.data(), b, e, faceNrm_.data());
+    });
+
+    // 2) 정점 → 코너 인접 리스트 (CSR, 병렬). 코너 번호 오름차순으로 채워서
+    //    합산 순서가 직렬 scatter 와 같음 → 스레드 수와 무관하게 같은 결과
+    std::vector<uint32_t> offset, corners;
+    parallel::groupByKey(rawIdx_.data(), rawIdx_.size(), vertexCount, offset, corners,
+                         [](size_t c) { return static_cast<uint32_t>(c); });
+
+    // 3) 정점마다 자기 코너만 모아서 더함 (gather – 쓰기 충돌이 없어 atomic 불필요).
+    //    합은 SoA 로 모아 구간 단위로 SIMD 정규화 후 vertNrm_ 에 기록
+    vertNrm_.resize(vertexCount);
+    geom::SoA3 sums;
+    sums.resize(vertexCount);
+    parallel::forRange(vertexCount, [&](size_t b, size_t e) {
+        for (size_t v = b; v < e; ++v) {
+            glm::vec3 sum(0.0f);
+            for (uint32_t k = offset[v]; k < offset[v + 1]; ++k) {
+                uint32_t c = corners[k];
+                int32_t n = obj.nrmIdx[c];
+                sum += (n >= 0) ? obj.normals[n]
+                                : faceNrm_[c / 3];   // 노멀 없으면 면노멀
+            }
+            sums.x[v] = sum.x; sums.y[v] = sum.y; sums.z[v] = sum.z;
+        }
+        geom::normalize(sums, b, e);
+        geom::toAoS(sums, b, e, vertNrm_.data());
+    });
+}
+
+void ModelLoader::loadMaterials(const std::string &filename, const ObjData &obj)
+{
+    materials_.clear();
+    faceMatIds_.clear();
+
+    // .mtl 은 obj 와 같은 디렉토리에서 찾음
+    std::string dir;
+    size_t slash = filename.find_last_of("/\\");
+    if (slash != std::string::npos) dir = filename.substr(0, slash + 1);
+
+    std::map<std::string, int> matMap;
+    for (const auto &lib : obj.mtlLibs) {
+        std::ifstream ifs(dir + lib);
+        if (!ifs) {
+            std::cerr << "[tinyobj warn] material file not found: " << dir + lib << "\n";
+            continue;
+        }
+        std::string warn, err;
+        tinyobj::LoadMtl(&matMap, &materials_, &ifs, &warn, &err);
+        if (!warn.empty()) std::cerr << "[tinyobj warn] " << warn << "\n";
+        if (!err.empty()) std::cerr << "[tinyobj err] " << err << "\n";
+    }
+
+    // usemtl 이름 순서 → materials_ 인덱스
+    std::vector<int> remap(obj.matNames.size(), -1);
+    for (size_t i = 0; i < obj.matNames.size(); ++i) {
+        auto it = matMap.find(obj.matNames[i]);
+        if (it != matMap.end()) remap[i] = it->second;
+    }
+
+    faceMatIds_.reserve(obj.faceMatIds.size());
+    for (int id : obj.faceMatIds)
+        faceMatIds_.push_back(id >= 0 ? remap[id] : -1);
+}
+
 void ModelLoader::rebuildVertices()
 {
     vertices_.clear(); indices_.clear();
-    vertices_.reserve(rawIdx_.size());
 
-    std::unordered_map<Vertex,uint32_t> uniq; // 동일한 Vertex 중복 저장을 막고 index 기반 렌더링을 위한 맵.
+    // 정점마다 노멀이 하나뿐이라 고유 버텍스 수 ≤ rawPos_ 개수
+    const size_t expected = std::min(rawPos_.size(), rawIdx_.size());
+    vertices_.reserve(expected);
+    indices_.reserve(rawIdx_.size());
+
+    // 동일한 Vertex 중복 저장을 막고 index 기반 렌더링을 위한 테이블 (키는 vertices_ 자체)
+    FlatIndexMap<Vertex, VertexBitHash, VertexBitEqual> uniq(expected);
     Vertex v;
 
     for(size_t i=0;i<rawIdx_.size();++i){
         uint32_t vid = rawIdx_[i];
         v.position   = rawPos_[vid];
         v.texcoord   = {};                      // (필요하면 채움)
-        v.normal     = (mode_==NormalMode::Face)
-                       ? faceNrm_[i/3]          // 삼각형 노멀
-                       : vertNrm_[vid];         // 평균 노멀
-
-        auto it = uniq.find(v);
-        if(it==uniq.end()){
-            uint32_t newId = vertices_.size();
-            uniq[v]=newId;
+        v.normal     = vertNrm_[vid];           // 평균 노멀 (Face 모드는 셰이더가 처리)
+
+        uint32_t newId = static_cast<uint32_t>(vertices_.size());
+        uint32_t id = uniq.findOrInsert(v, newId, vertices_.data());
+        if (id == newId)
             vertices_.push_back(v);
-            indices_.push_back(newId);
-        }else
-            indices_.push_back(it->second);
+        indices_.push_back(id);
+    }
+}
+
+void ModelLoader::permuteTriangles(const std::vector<uint32_t> &order)
+{
+    // 삼각형 순서만 바뀌므로 삼각형 단위 배열도 전부 같은 순서로 옮김 (uploadOnly_ 면 나머지는 이미 해제됨)
+    MeshOptimizer::permuteTriangles(indices_, order, 3);
+    if (uploadOnly_) return;
+    MeshOptimizer::permuteTriangles(rawIdx_, order, 3);
+    MeshOptimizer::permuteTriangles(faceNrm_, order);
+    MeshOptimizer::permuteTriangles(faceMatIds_, order);
+    MeshOptimizer::permuteTriangles(sourceFaces_, order);
+}
+
+void ModelLoader::optimizeMeshOrder()
+{
+    using namespace MeshOptimizer;
+    auto t0 = std::chrono::steady_clock::now();
+    const auto cacheBefore = analyzeVertexCache(indices_.data(), indices_.size(), vertices_.size());
+    const auto fetchBefore = analyzeVertexFetch(indices_.data(), indices_.size(), vertices_.size(), sizeof(Vertex));
+
+    // 1) 삼각형 순서: Morton 으로 공간 순서를 먼저 잡고, 그 위에서 post‑transform 캐시 최적화.
+    //    큰 메쉬는 클러스터(Morton 순서의 연속 구간)를 깨지 않도록 구간 안에서만 최적화
+    const bool clustered = indices_.size() / 3 > kClusterTriangles;
+    if (order_ == MeshOrder::Morton || clustered)
+        permuteTriangles(mortonTriangleOrder(indices_.data(), indices_.size(), &vertices_[0].position,
+                                             sizeof(Vertex), center_, maxExtent_));
+    if (optimizeOrder_)
+        permuteTriangles(clustered
+                         ? optimizeVertexCacheClustered(indices_.data(), indices_.size(), kClusterTriangles)
+                         : optimizeVertexCache(indices_.data(), indices_.size(), vertices_.size()));
+
+    // 2) 클러스터 안의 캐시 순서를 그대로 잘라 meshlet 으로 나눔 (뒷면 콘 컬링 단위, 경계는 캐시에 저장)
+    meshletTris_ = buildMeshlets(indices_.data(), indices_.size(), &vertices_[0].position, sizeof(Vertex),
+                                 kClusterTriangles, kMeshletVertices, kMeshletTriangles);
+
+    // 3) 정점 순서: GPU 버텍스와 CPU 원본(rawPos_/vertNrm_) 을 각자의 인덱스에 맞게 재배치
+    auto remap = (order_ == MeshOrder::Morton)
+                 ? mortonRemap(&vertices_[0].position, vertices_.size(), sizeof(Vertex), center_, maxExtent_)
+                 : firstUseRemap(indices_.data(), indices_.size(), vertices_.size());
+    remapVertices(vertices_, remap);
+    remapIndices(indices_, remap);
+
+    if (!uploadOnly_) {
+        remap = (order_ == MeshOrder::Morton)
+                ? mortonRemap(rawPos_.data(), rawPos_.size(), sizeof(glm::vec3), center_, maxExtent_)
+                : firstUseRemap(rawIdx_.data(), rawIdx_.size(), rawPos_.size());
+        remapVertices(rawPos_, remap);
+        remapVertices(vertNrm_, remap);
+        remapVertices(sourceVertices_, remap);
+        remapIndices(rawIdx_, remap);
+    }
+
+    const auto cacheAfter = analyzeVertexCache(indices_.data(), indices_.size(), vertices_.size());
+    const auto fetchAfter = analyzeVertexFetch(indices_.data(), indices_.size(), vertices_.size(), sizeof(Vertex));
+    orderStats_ = {cacheBefore.acmr, cacheAfter.acmr, cacheBefore.atvr, cacheAfter.atvr,
+                   fetchBefore.overfetch, fetchAfter.overfetch};
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    const double mb = 1.0 / (1024.0 * 1024.0);
+    std::cerr << "[ModelLoader] mesh order (" << (order_ == MeshOrder::Morton ? "morton" : "first-use")
+              << (optimizeOrder_ ? (clustered ? " + clustered vcache" : " + vcache") : "") << "): ACMR " << cacheBefore.acmr << " -> " << cacheAfter.acmr
+              << ", ATVR " << cacheBefore.atvr << " -> " << cacheAfter.atvr
+              << ", fetch " << fetchBefore.bytesFetched * mb << " -> " << fetchAfter.bytesFetched * mb << " MB"
+              << " (overfetch " << fetchBefore.overfetch << " -> " << fetchAfter.overfetch << ", "
+              << ms << " ms)\n";
+}
+
+void ModelLoader::buildClusters()
+{
+    clusters_.clear();
+    meshlets_.clear();
+    const size_t triCount = indices_.size() / 3;
+    if (triCount == 0) return;
+
+    // meshlet 경계 (삼각형 수 목록) → 인덱스 구간. 안 맞으면 (예전 캐시 등) 콘 컬링 없이 진행
+    size_t covered = 0;
+    for (uint32_t n : meshletTris_) covered += n;
+    if (covered == triCount) {
+        meshlets_.resize(meshletTris_.size());
+        uint32_t first = 0;
+        for (size_t i = 0; i < meshlets_.size(); ++i) {
+            meshlets_[i].firstIndex = first;
+            meshlets_[i].indexCount = 3 * meshletTris_[i];
+            first += meshlets_[i].indexCount;
+        }
+        parallel::forRange(meshlets_.size(), [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) computeMeshletBounds(vertices_, indices_.data(), meshlets_[i]);
+        }, 256);
+    }
+    if (triCount > kClusterTriangles) {
+        // meshlet 은 클러스터 경계를 넘지 않으므로 순서대로 걸어가며 클러스터에 배정
+        clusters_.resize((triCount + kClusterTriangles - 1) / kClusterTriangles);
+        size_t m = 0;
+        for (size_t c = 0; c < clusters_.size(); ++c) {
+            MeshCluster &cl = clusters_[c];
+            cl.firstIndex = static_cast<uint32_t>(c * kClusterTriangles * 3);
+            cl.indexCount = static_cast<uint32_t>(std::min(kClusterTriangles * 3, indices_.size() - cl.firstIndex));
+            cl.firstMeshlet = static_cast<uint32_t>(m);
+            while (m < meshlets_.size() && meshlets_[m].firstIndex < cl.firstIndex + cl.indexCount) ++m;
+            cl.meshletCount = static_cast<uint32_t>(m - cl.firstMeshlet);
+        }
+        parallel::forEachTask(clusters_.size(), [&](size_t c) {
+            MeshCluster &cl = clusters_[c];
+            cl.bboxMin = glm::vec3(1e9f);
+            cl.bboxMax = glm::vec3(-1e9f);
+            for (size_t i = cl.firstIndex; i < size_t(cl.firstIndex) + cl.indexCount; ++i) {
+                const glm::vec3 &p = vertices_[indices_[i]].position;
+                cl.bboxMin = glm::min(cl.bboxMin, p);
+                cl.bboxMax = glm::max(cl.bboxMax, p);
+            }
+        });
+    }
+
+    size_t cullable = 0;
+    for (const Meshlet &ml : meshlets_) cullable += ml.coneCutoff < 1.0f;
+    std::cerr << "[ModelLoader] " << clusters_.size() << " clusters, " << meshlets_.size() << " meshlets ("
+              << (meshlets_.empty() ? 0.0 : 100.0 * cullable / meshlets_.size()) << "% with a usable normal cone)\n";
+}
+
+LodChain ModelLoader::buildLods(const std::atomic<bool> *cancel) const
+{
+    LodChain chain;
+    const size_t triCount = indices_.size() / 3;
+    if (triCount < kLodMinTriangles) return chain;
+
+    chain.levels.push_back({0, static_cast<uint32_t>(indices_.size()), 0.0f});
+    const float ratios[] = {0.5f, 0.25f, 0.1f, 0.02f};
+    const uint32_t *src = indices_.data();
+    size_t srcCount = indices_.size();
+    float error = 0.0f;
+
+    for (float ratio : ratios) {
+        auto t0 = std::chrono::steady_clock::now();
+        size_t target = static_cast<size_t>(triCount * ratio) * 3;
+        MeshSimplifier::Result res;
+        if (!MeshSimplifier::simplify(src, srcCount, &vertices_[0].position, sizeof(Vertex), vertices_.size(),
+                                      target, res, cancel))
+            return LodChain();
+        // 10% 도 못 줄였으면 (경계·잠긴 정점 때문에 막힘) 더 거친 단계는 의미 없음
+        if (res.indices.empty() || res.indices.size() * 10 > srcCount * 9) break;
+
+        // 직전 LOD 에서 이어서 줄였으므로 오차는 단계마다 누적 (보수적으로 합산)
+        error += res.error;
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        std::cerr << "[ModelLoader] LOD" << chain.levels.size() << ": " << res.indices.size() / 3
+                  << " tris, error " << error / maxExtent_ << " x extent (" << ms << " ms)\n";
+
+        const size_t first = indices_.size() + chain.indices.size();
+        chain.indices.insert(chain.indices.end(), res.indices.begin(), res.indices.end());
+        chain.levels.push_back({static_cast<uint32_t>(first), static_cast<uint32_t>(res.indices.size()), error});
+        src = chain.indices.data() + (first - indices_.size());
+        srcCount = res.indices.size();
     }
+    if (chain.levels.size() == 1) chain.levels.clear();
+    return chain;
 }
 
 void ModelLoader::setNormalMode(NormalMode m)
 {
-    if (mode_ == m) return;
+    // 두 모드가 같은 버퍼를 쓰므로 CPU 배열은 그대로 (phong.frag 의 uFlat 으로 전환)
     mode_ = m;
-    rebuildVertices();          // CPU 배열 갱신
 }
@@ -1,13 +1,26 @@
 #ifndef MODELLOADER_H
 #define MODELLOADER_H
 
+#include <atomic>
+#include <cstring>
+#include <functional>
 #include <string>
 #include <vector>
 #include <glm/glm.hpp>
 #include <tiny_obj_loader.h>
+#include "FlatIndexMap.h"
+
+struct ObjData;
+namespace geom { struct SoA3; }
 
 enum class NormalMode { Vertex, Face };
 
+/// 로드 후 정점 / 삼각형 배치 순서
+enum class MeshOrder {
+    FirstUse, // 정점을 인덱스에서 처음 쓰이는 순서로
+    Morton    // 삼각형·정점 모두 bbox 위 Z‑order 곡선 순서로
+};
+
 /// 단일 정점 구조 – 인덱스 기반으로 묶어서 사용
 struct Vertex {
     glm::vec3 position{};
@@ -20,40 +33,234 @@ struct Vertex {
                texcoord == rhs.texcoord;
     }
 };
+static_assert(sizeof(Vertex) == 32, "Vertex 에 padding 이 없어야 비트 단위 해시가 맞음");
 
-/// Vertex를 key로 사용하기 위한 해시
+/// 비트 단위 해시/비교 – 8개 float 의 비트 패턴을 그대로 사용 (-0.0 과 0.0 은 다른 키)
+struct VertexBitHash {
+    uint64_t operator()(const Vertex &v) const noexcept {
+        uint64_t w[4];
+        std::memcpy(w, &v, sizeof w);
+        uint64_t h = 0x9E3779B97F4A7C15ULL;
+        for (uint64_t x : w) h = (h ^ hashMix64(x)) * 0x9E3779B97F4A7C15ULL;
+        return hashMix64(h);
+    }
+};
+
+struct VertexBitEqual {
+    bool operator()(const Vertex &a, const Vertex &b) const noexcept {
+        return std::memcmp(&a, &b, sizeof(Vertex)) == 0;
+    }
+};
+
+/// Vertex를 key로 사용하기 위한 해시. Vertex::operator== (float 비교) 와 맞도록 -0.0 을 0.0 으로 바꾼 뒤 비트 해시
 namespace std {
     template<>
     struct hash<Vertex> {
         size_t operator()(const Vertex &v) const noexcept {
-            auto h1 = hash<float>()(v.position.x) ^ (hash<float>()(v.position.y) << 1);
-            auto h2 = hash<float>()(v.position.z) ^ (hash<float>()(v.normal.x) << 1);
-            auto h3 = hash<float>()(v.normal.y) ^ (hash<float>()(v.normal.z) << 1);
-            auto h4 = hash<float>()(v.texcoord.x) ^ (hash<float>()(v.texcoord.y) << 1);
-            return h1 ^ h2 ^ h3 ^ h4;
+            float f[8];
+            std::memcpy(f, &v, sizeof f);
+            for (float &x : f)
+                if (x == 0.0f) x = 0.0f;
+            Vertex canonical;
+            std::memcpy(&canonical, f, sizeof f);
+            return static_cast<size_t>(VertexBitHash()(canonical));
         }
     };
 }
 
+/// 스트리밍 로드 중 미리보기용 삼각형 묶음 (면노멀을 가진 triangle soup, 삼각형당 정점 3개)
+struct MeshBatch {
+    std::vector<Vertex> vertices;
+    glm::vec3 bboxMin{}, bboxMax{}; // 지금까지 읽은 정점 전체의 bbox
+};
+
+/// 백그라운드 로드의 진행률 보고 / 취소 요청.
+/// onProgress 는 파싱 스레드들에서 동시에 불릴 수 있으므로 스레드 안전해야 함
+struct LoadControl {
+    std::atomic<bool> cancel{false};
+    std::function<void(float fraction, const char *stage)> onProgress;
+
+    /// 설정하면 큰 파일을 파싱하는 동안 완성된 삼각형을 파일 순서대로 넘겨줌 (호출은 직렬화됨)
+    std::function<void(MeshBatch &&batch)> onBatch;
+    size_t previewBudget = 2'000'000; // 미리보기로 보낼 최대 삼각형 수
+};
+
+/// load() 의 단계별 소요 시간 (ms). 캐시에서 읽었으면 cacheRead / clusters 만 채워짐
+struct LoadTimings {
+    double cacheRead = 0.0;
+    double parse = 0.0;
+    double normals = 0.0;  // 머티리얼 + 면 / 정점 노멀 + bbox
+    double vertices = 0.0; // rebuildVertices (중복 제거)
+    double optimize = 0.0; // 삼각형 / 정점 순서 재배치
+    double clusters = 0.0; // 클러스터 / meshlet 경계
+    double cacheWrite = 0.0;
+    double total = 0.0;
+};
+
+/// 순서 재배치 전후의 캐시 / fetch 지표 (MeshOptimizer::analyze*). 캐시에서 읽었으면 모두 0
+struct MeshOrderStats {
+    float acmrBefore = 0.0f, acmrAfter = 0.0f;
+    float atvrBefore = 0.0f, atvrAfter = 0.0f;
+    float overfetchBefore = 0.0f, overfetchAfter = 0.0f;
+};
+
+/// 컨테이너 하나가 잡고 있는 힙 바이트 (size 가 아니라 capacity 기준)
+struct MemoryEntry {
+    const char *name;
+    size_t bytes;
+};
+
+/// load() 중 메모리 (바이트). RSS 는 프로세스 전체 값이라 다른 스레드의 작업도 섞임
+struct LoadMemory {
+    size_t parser = 0;    // 파싱 직후 ObjData 전체 (위치 / 인덱스는 rawPos_ / rawIdx_ 로 넘어가고 나머지는 버려짐)
+    size_t rssBefore = 0;
+    size_t rssPeak = 0;
+    size_t rssAfter = 0;
+    bool peakIsLocal = false; // false 면 rssPeak 는 이 로드가 아니라 프로세스 시작 이후 최대값
+};
+
+/// 공간적으로 모여 있는 연속 삼각형 구간 (프러스텀 컬링 단위). bbox 는 모델 좌표
+struct MeshCluster {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    glm::vec3 bboxMin{}, bboxMax{};
+    uint32_t firstMeshlet = 0; // 이 구간을 나눈 meshlets() 범위
+    uint32_t meshletCount = 0;
+};
+
+/// 정점 kMeshletVertices / 삼각형 kMeshletTriangles 이하의 작은 연속 구간 + 노멀 콘 (뒷면 컬링 단위).
+/// 카메라 e 에 대해 dot(c - e, axis) >= coneCutoff·|c - e| + radius 이면 전부 뒷면
+struct Meshlet {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    glm::vec3 center{};      // 경계 구 (모델 좌표)
+    float radius = 0.0f;
+    glm::vec3 coneAxis{};    // 면 노멀 평균 방향
+    float coneCutoff = 1.0f; // sin(콘 반각). 1 이면 컬링 불가 (노멀이 반구 이상으로 퍼짐)
+};
+
+/// lean 모드로 해제했다가 다시 읽은 GPU 업로드용 배열 (ModelLoader::reloadUploadData)
+struct UploadData {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+};
+
+/// 단순화된 인덱스 구간 하나. 모든 LOD 가 같은 정점 버퍼를 공유
+struct LodLevel {
+    uint32_t firstIndex = 0; // EBO 안의 시작 위치 (LOD0 = indices_ 다음에 LOD1.. 이 이어짐)
+    uint32_t indexCount = 0;
+    float error = 0.0f;      // 모델 좌표 기준 기하 오차
+};
+
+struct LodChain {
+    std::vector<uint32_t> indices; // LOD1.. 을 이어 붙인 것 (LOD0 은 indices_ 그대로)
+    std::vector<LodLevel> levels;  // levels[0] = 원본 메쉬
+};
+
 class ModelLoader {
 public:
-    bool load(const std::string &filename, bool triangulate = true);
+    /// 이보다 작은 파일은 어차피 금방 끝나므로 미리보기 배치를 만들지 않음
+    static constexpr size_t kPreviewMinBytes = size_t(16) << 20;
+
+    /// ctl 이 있으면 진행률을 보고하고 취소 요청을 확인함.
+    /// 취소되면 false 를 돌려주며 이때 객체 상태는 불완전하므로 버려야 함
+    bool load(const std::string &filename, bool triangulate = true, LoadControl *ctl = nullptr);
 
     NormalMode normalMode() const { return mode_; }
 
-    void setNormalMode(NormalMode m); // face ↔ vertex 토글
+    const LoadTimings &timings() const { return timings_; } // 마지막 load()
+    const MeshOrderStats &orderStats() const { return orderStats_; }
+    const LoadMemory &loadMemory() const { return loadMemory_; }
+
+    /// 지금 들고 있는 배열별 메모리 (rawPos_, rawIdx_, faceNrm_, vertNrm_, vertices_, indices_ ...)
+    std::vector<MemoryEntry> memoryUsage() const;
+    size_t memoryBytes() const; // memoryUsage() 합계
+
+    void setNormalMode(NormalMode m); // face ↔ vertex 토글 (버퍼 공유, 셰이더에서 전환)
+
+    /// <obj>.meshcache 사용 여부 (기본 on). 끄면 항상 텍스트를 파싱
+    void setUseCache(bool on) { useCache_ = on; }
+    bool loadedFromCache() const { return fromCache_; }
+
+    /// 중복 제거 후 삼각형 순서를 post‑transform 캐시에 맞게 재배치 (기본 off, 캐시 키에 포함).
+    /// 큰 메쉬에서는 로드 시간의 대부분을 차지하므로 필요할 때만 켬
+    void setOptimizeIndexOrder(bool on) { optimizeOrder_ = on; }
+
+    /// 정점 fetch 지역성을 위한 재배치 방식 (기본 FirstUse, 캐시 키에 포함)
+    void setMeshOrder(MeshOrder order) { order_ = order; }
+
+    /// OBJ 파싱 스레드 수 (기본 0 = 하드웨어 스레드 수). 결과는 같고 속도만 다름 (벤치마크의 1 스레드 기준용)
+    void setParseThreads(unsigned n) { parseThreads_ = n; }
 
-    const std::vector<Vertex> &vertices() const { return vertices_; }
-    const std::vector<uint32_t> &indices() const { return indices_; }
+    /// 파싱한 원래 위치 / 삼각형 인덱스 (중복 제거 전). 삼각형 순서는 indices() 와 같음
+    const std::vector<glm::vec3> &rawPositions() const { return rawPos_; }
+    const std::vector<uint32_t> &rawIndices() const { return rawIdx_; }
+
+    const std::vector<Vertex> &vertices() const { return vertices_; }   // releaseUploadData() 뒤엔 비어 있음
+    const std::vector<uint32_t> &indices() const { return indices_; }  // 〃
+    size_t vertexCount() const { return released_ ? releasedVertices_ : vertices_.size(); }
+    size_t indexCount() const { return released_ ? releasedIndices_ : indices_.size(); }
+
+    /// GPU 에 올린 뒤 필요 없는 CPU 사본 (vertices_, indices_, faceNrm_, vertNrm_) 해제 (lean 모드).
+    /// 피킹용 rawPos_ / rawIdx_ 와 클러스터 / meshlet / LOD 는 그대로.
+    /// buildLods() 가 다른 스레드에서 돌고 있으면 부르면 안 됨
+    void releaseUploadData();
+    bool uploadDataReleased() const { return released_; }
+
+    /// 해제한 vertices_ / indices_ 를 out 에 다시 만듦 (재업로드용). .meshcache 의 두 섹션만 읽고, 없으면 OBJ 를 다시
+    /// 파싱하되 이 두 배열까지만 만듦 (LOD / 클러스터 / 캐시 쓰기 없음). 해제할 때의 내용 해시와 같은지 확인
+    /// (파일이 바뀌었으면 rawPos_ / BVH / 클러스터와 어긋나므로 실패).
+    /// 객체를 바꾸지 않으므로 워커 스레드에서 불러도 됨. ctl 로 취소하면 false
+    bool reloadUploadData(UploadData &out, LoadControl *ctl = nullptr) const;
+
+    /// reloadUploadData() 결과를 다시 넣음. 노멀 배열은 로드 이후 쓰이지 않으므로 복원하지 않음
+    void restoreUploadData(UploadData &&data);
     const std::vector<tinyobj::material_t> &materials() const { return materials_; }
     const glm::vec3 &center() const { return center_; }
     float maxExtent() const { return maxExtent_; }
 
+    /// 클러스터 하나의 삼각형 수. 이보다 큰 메쉬는 Morton 순서로 잘라 구간마다 캐시 최적화
+    static constexpr size_t kClusterTriangles = 4096;
+
+    /// indices_ 를 kClusterTriangles 개씩 나눈 구간 (메쉬가 한 구간 이하면 비어 있음)
+    const std::vector<MeshCluster> &clusters() const { return clusters_; }
+
+    static constexpr size_t kMeshletVertices = 64;
+    static constexpr size_t kMeshletTriangles = 124;
+
+    /// indices_ 의 연속 구간으로 된 meshlet (클러스터 경계는 넘지 않음, 인덱스 순서대로 나열)
+    const std::vector<Meshlet> &meshlets() const { return meshlets_; }
+
+    /// 이보다 작은 메쉬는 LOD 를 만들지 않음
+    static constexpr size_t kLodMinTriangles = 4096;
+
+    /// 원본의 50/25/10/2% 삼각형 LOD 를 차례로 단순화 (각 단계는 직전 LOD 에서 시작).
+    /// 무거워서 워커 스레드에서 부르고 결과는 setLods 로 넘김. cancel 되면 빈 체인
+    LodChain buildLods(const std::atomic<bool> *cancel = nullptr) const;
+    void setLods(LodChain &&lods) { lods_ = std::move(lods); }
+    const std::vector<LodLevel> &lods() const { return lods_.levels; }
+    const std::vector<uint32_t> &lodIndices() const { return lods_.indices; }
+
     /// face(i) 가 어떤 material id를 쓰는지 (indices는 3‑배수 단위)
     const std::vector<int> &materialIdsPerFace() const { return faceMatIds_; }
 
+    /// 삼각형 → OBJ 의 f 문 번호, rawPositions 번호 → v 문 번호 (둘 다 0‑based).
+    /// 순서 최적화가 삼각형과 정점을 재배치하므로 파일 기준 번호를 보여줄 때 (피킹) 이걸로 되돌림
+    const std::vector<uint32_t> &sourceFaces() const { return sourceFaces_; }
+    const std::vector<uint32_t> &sourceVertices() const { return sourceVertices_; }
+
 private:
+    friend class MeshCache;
+
+    uint32_t cacheKey(bool triangulate) const; // 캐시 키에 들어가는 로드 옵션 비트
     void rebuildVertices();
+    void permuteTriangles(const std::vector<uint32_t> &order); // indices_ / rawIdx_ / faceNrm_ / faceMatIds_ / sourceFaces_
+    void optimizeMeshOrder(); // 삼각형 순서 + 정점 순서 재배치, 전후 캐시·fetch 지표 로그
+    void buildClusters();     // 최종 삼각형 순서에서 clusters_ / meshlets_ 계산 (캐시에서 읽은 뒤에도)
+
+    /// faceNrm_ / vertNrm_ 계산. 면 노멀과 정점별 gather 를 병렬로 수행 (pos = rawPos_ 의 SoA 사본)
+    void computeNormals(const ObjData &obj, const geom::SoA3 &pos);
+    void loadMaterials(const std::string &filename, const ObjData &obj); // mtllib / usemtl 처리
 
     // 노말 모드 변경을 위해 원래 정보들을 저장해둠
     std::vector<glm::vec3> rawPos_;
@@ -67,8 +274,28 @@ private:
 
     std::vector<tinyobj::material_t> materials_;
     std::vector<int> faceMatIds_; // face(삼각형) 단위 material id
+    std::vector<uint32_t> sourceFaces_;    // 삼각형 단위 f 문 번호
+    std::vector<uint32_t> sourceVertices_; // rawPos_ 단위 v 문 번호
+    std::vector<MeshCluster> clusters_;
+    std::vector<Meshlet> meshlets_;
+    std::vector<uint32_t> meshletTris_; // meshlet 마다 삼각형 수 (순서 최적화 때 정해지고 캐시에 저장)
+    LodChain lods_;
 
     NormalMode mode_ = NormalMode::Vertex;
+    bool useCache_ = true;
+    bool optimizeOrder_ = false;
+    MeshOrder order_ = MeshOrder::FirstUse;
+    unsigned parseThreads_ = 0;
+    bool uploadOnly_ = false; // reloadUploadData() 용: vertices_ / indices_ 까지만 만들고 나머지는 버림
+    bool fromCache_ = false;
+    LoadTimings timings_;
+    MeshOrderStats orderStats_;
+    LoadMemory loadMemory_;
+    std::string filename_; // 마지막 load() 인자 (reloadUploadData 용)
+    bool triangulate_ = true;
+    bool released_ = false;
+    size_t releasedVertices_ = 0, releasedIndices_ = 0;
+    uint64_t releasedHash_ = 0; // 해제한 vertices_ + indices_ 의 내용 해시
     glm::vec3 center_{};
     float maxExtent_ = 1.0f;
 };
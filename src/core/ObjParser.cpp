@@ -0,0 +1,491 @@
+#include "ObjParser.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+// ---------------------------------------------------------------------------
+// 토큰화 유틸
+// ---------------------------------------------------------------------------
+namespace {
+    inline bool isSpace(char c) { return c == ' ' || c == '\t'; }
+    inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    inline const char *skipSpace(const char *p, const char *end) {
+        while (p < end && isSpace(*p)) ++p;
+        return p;
+    }
+
+    inline const char *skipToken(const char *p, const char *end) {
+        while (p < end && !isSpace(*p)) ++p;
+        return p;
+    }
+
+    const double kPow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    /// 실수 파서: 19자리 정수 가수 + 10의 거듭제곱 테이블 (strtod 대비 수 배 빠름)
+    /// 숫자가 없으면 nullptr
+    const char *parseReal(const char *p, const char *end, float &out) {
+        bool neg = false;
+        if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+
+        uint64_t mant = 0;
+        int digits = 0, exp10 = 0;
+        bool any = false;
+        for (; p < end && isDigit(*p); ++p) {
+            any = true;
+            if (digits < 19) {
+                mant = mant * 10 + (*p - '0');
+                if (mant) ++digits;
+            } else {
+                ++exp10;
+            }
+        }
+        if (p < end && *p == '.') {
+            for (++p; p < end && isDigit(*p); ++p) {
+                any = true;
+                if (digits < 19) {
+                    mant = mant * 10 + (*p - '0');
+                    if (mant) ++digits;
+                    --exp10;
+                }
+            }
+        }
+        if (!any) return nullptr;
+
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            const char *q = p + 1;
+            bool eneg = false;
+            if (q < end && (*q == '-' || *q == '+')) eneg = (*q++ == '-');
+            if (q < end && isDigit(*q)) {
+                int e = 0;
+                for (; q < end && isDigit(*q); ++q)
+                    if (e < 10000) e = e * 10 + (*q - '0');
+                exp10 += eneg ? -e : e;
+                p = q;
+            }
+        }
+
+        double v = static_cast<double>(mant);
+        if (exp10 < 0)
+            v = (exp10 >= -22) ? v / kPow10[-exp10] : v * std::pow(10.0, exp10);
+        else if (exp10 > 0)
+            v = (exp10 <= 22) ? v * kPow10[exp10] : v * std::pow(10.0, exp10);
+        out = static_cast<float>(neg ? -v : v);
+        return p;
+    }
+
+    /// 부호 있는 정수. 숫자가 없으면 nullptr
+    const char *parseInt(const char *p, const char *end, int64_t &out) {
+        bool neg = false;
+        if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+        if (p >= end || !isDigit(*p)) return nullptr;
+        int64_t v = 0;
+        for (; p < end && isDigit(*p); ++p)
+            v = v * 10 + (*p - '0');
+        out = neg ? -v : v;
+        return p;
+    }
+
+    /// x y z 세 실수를 읽음. 누락/잘못된 값은 0 (tinyobj 와 동일하게 관대하게 처리)
+    void parseVec3(const char *p, const char *end, glm::vec3 &v) {
+        for (int k = 0; k < 3; ++k) {
+            p = skipSpace(p, end);
+            float f = 0.0f;
+            const char *q = parseReal(p, end, f);
+            v[k] = q ? f : 0.0f;
+            p = q ? q : skipToken(p, end);
+        }
+    }
+
+    /// OBJ 인덱스(1‑based, 음수는 상대) → 0‑based 절대 인덱스. 잘못되면 -1
+    inline int64_t resolveIndex(int64_t idx, size_t count) {
+        if (idx > 0) return idx - 1;
+        if (idx < 0) return static_cast<int64_t>(count) + idx;
+        return -1;
+    }
+
+    inline bool keyword(const char *p, const char *end, const char *kw, size_t n) {
+        return static_cast<size_t>(end - p) > n && std::memcmp(p, kw, n) == 0 && isSpace(p[n]);
+    }
+
+    std::string trimmed(const char *p, const char *end) {
+        p = skipSpace(p, end);
+        while (end > p && isSpace(end[-1])) --end;
+        return {p, end};
+    }
+
+    constexpr int kInheritMat = -2; // 청크 시작 ~ 첫 usemtl 사이: 앞 청크의 재질을 이어받음
+
+    /// 병렬 파싱에서 청크 하나의 결과 + 병합 시 보정할 정보
+    struct Chunk {
+        const char *begin = nullptr, *end = nullptr;
+        ObjData data;
+        std::vector<size_t> relPos;  // 상대(음수) 인덱스였던 posIdx 슬롯 → 병합 때 정점 base 를 더함
+        std::vector<size_t> relNrm;  // nrmIdx 도 동일
+        int lastMat = kInheritMat;   // 청크 끝 시점의 usemtl (data.matNames 기준)
+        bool ok = true;
+        const char *errAt = nullptr;
+        std::string err;
+    };
+
+    constexpr size_t kProgressTick = size_t(1) << 20; // 진행률 보고 / 취소 확인 간격 (바이트)
+
+    /// [begin, end) 를 파싱. chunk 가 nullptr 이 아니면 음수 인덱스를 청크‑로컬 값으로 남기고
+    /// 슬롯을 기록해 둠 (앞 청크들의 정점 수를 아직 모르기 때문)
+    bool parseRange(const char *begin, const char *end, ObjData &out, bool triangulate,
+                    Chunk *chunk, const ObjParser::Progress &progress,
+                    std::string &err, const char *&errAt) {
+        struct Corner { uint32_t v; int32_t n; bool relV, relN; };
+        std::vector<Corner> poly; // 한 face 의 코너들 (재사용)
+        int curMat = chunk ? kInheritMat : -1;
+
+        auto fail = [&](const char *at, const char *msg) {
+            errAt = at;
+            err = msg;
+            return false;
+        };
+
+        const char *p = begin;
+        const char *reported = begin, *tick = begin; // 시작할 때도 한 번 취소 확인
+        while (p < end) {
+            if (progress && p >= tick) {
+                if (!progress(static_cast<size_t>(p - reported))) return fail(nullptr, "cancelled");
+                reported = p;
+                tick = p + kProgressTick;
+            }
+            const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+            const char *next = eol ? eol + 1 : end;
+            const char *le = eol ? eol : end;
+            if (le > p && le[-1] == '\r') --le; // CRLF
+
+            const char *line = p;
+            p = skipSpace(p, le);
+            if (p >= le || *p == '#') { p = next; continue; }
+
+            if (p[0] == 'v') {
+                if (le - p > 1 && isSpace(p[1])) {
+                    glm::vec3 v;
+                    parseVec3(p + 2, le, v);
+                    out.positions.push_back(v);
+                } else if (keyword(p, le, "vn", 2)) {
+                    glm::vec3 n;
+                    parseVec3(p + 3, le, n);
+                    out.normals.push_back(n);
+                } else if (keyword(p, le, "vt", 2)) {
+                    ++out.texcoordCount;
+                }
+            } else if (p[0] == 'f' && le - p > 1 && isSpace(p[1])) {
+                const uint32_t face = static_cast<uint32_t>(out.faceCount++); // 청크 안 번호 (병합 때 보정)
+                poly.clear();
+                const char *q = skipSpace(p + 2, le);
+                while (q < le && *q != '#') { // 줄 끝 주석 (f 1 2 3 # ...)
+                    int64_t vi = 0, ni = 0, ti = 0;
+                    const char *r = parseInt(q, le, vi);
+                    if (!r) return fail(line, "malformed face");
+                    bool hasN = false;
+                    if (r < le && *r == '/') {
+                        ++r;
+                        if (const char *t = parseInt(r, le, ti)) r = t;      // vt (사용 안 함)
+                        if (r < le && *r == '/') {
+                            ++r;
+                            if (const char *t = parseInt(r, le, ni)) { r = t; hasN = true; }
+                        }
+                    }
+                    if (vi == 0 || (hasN && ni == 0)) return fail(line, "invalid face index");
+
+                    Corner c{};
+                    c.relV = chunk && vi < 0;
+                    c.relN = chunk && hasN && ni < 0;
+                    int64_t v = c.relV ? static_cast<int64_t>(out.positions.size()) + vi
+                                       : resolveIndex(vi, out.positions.size());
+                    int64_t n = !hasN ? -1
+                              : c.relN ? static_cast<int64_t>(out.normals.size()) + ni
+                                       : resolveIndex(ni, out.normals.size());
+                    if (!chunk && (v < 0 || (hasN && n < 0))) return fail(line, "invalid face index");
+                    c.v = static_cast<uint32_t>(v);
+                    c.n = static_cast<int32_t>(n);
+                    poly.push_back(c);
+                    while (r < le && !isSpace(*r) && *r != '#') ++r;
+                    q = skipSpace(r, le);
+                }
+                if (poly.size() < 3) { p = next; continue; } // 선분/점은 무시
+
+                // fan 삼각화
+                size_t last = triangulate ? poly.size() - 1 : 2;
+                for (size_t k = 1; k < last; ++k) {
+                    const Corner c[3] = {poly[0], poly[k], poly[k + 1]};
+                    for (const Corner &cc : c) {
+                        if (cc.relV) chunk->relPos.push_back(out.posIdx.size());
+                        if (cc.relN) chunk->relNrm.push_back(out.nrmIdx.size());
+                        out.posIdx.push_back(cc.v);
+                        out.nrmIdx.push_back(cc.n);
+                    }
+                    out.faceMatIds.push_back(curMat);
+                    out.faceIds.push_back(face);
+                }
+            } else if (keyword(p, le, "usemtl", 6)) {
+                std::string name = trimmed(p + 7, le);
+                curMat = -1;
+                for (size_t i = 0; i < out.matNames.size(); ++i)
+                    if (out.matNames[i] == name) { curMat = static_cast<int>(i); break; }
+                if (curMat < 0) {
+                    curMat = static_cast<int>(out.matNames.size());
+                    out.matNames.push_back(std::move(name));
+                }
+            } else if (keyword(p, le, "mtllib", 6)) {
+                const char *q = skipSpace(p + 7, le);
+                while (q < le) {
+                    const char *t = skipToken(q, le);
+                    out.mtlLibs.emplace_back(q, t);
+                    q = skipSpace(t, le);
+                }
+            }
+            // o, g, s, l, p 등은 무시
+            p = next;
+        }
+        if (chunk) chunk->lastMat = curMat;
+        if (progress) progress(static_cast<size_t>(end - reported));
+        return true;
+    }
+
+    std::string lineMessage(const char *fileBegin, const char *at, const std::string &msg) {
+        if (!at) return msg;
+        size_t line = 1 + std::count(fileBegin, at, '\n');
+        return "line " + std::to_string(line) + ": " + msg;
+    }
+
+    /// 앞쪽에서 정의되지 않은 정점/노멀을 참조하는 face 검사
+    bool validate(const ObjData &out, std::string &err) {
+        const size_t nv = out.positions.size(), nn = out.normals.size();
+        std::atomic<bool> bad{false};
+        parallel::forRange(out.posIdx.size(), [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i)
+                if (out.posIdx[i] >= nv || (out.nrmIdx[i] >= 0 && static_cast<size_t>(out.nrmIdx[i]) >= nn))
+                    bad = true;
+        }, size_t(1) << 20);
+        if (bad) err = "face references undefined vertex or normal";
+        return !bad;
+    }
+
+    /// 청크별 결과를 prefix sum 으로 한 배열에 모음. 상대 인덱스와 재질 id 를 전역 값으로 보정
+    bool mergeChunks(std::vector<Chunk> &chunks, ObjData &out, std::string &err) {
+        const size_t nc = chunks.size();
+        std::vector<size_t> posBase(nc + 1, 0), nrmBase(nc + 1, 0), idxBase(nc + 1, 0), triBase(nc + 1, 0);
+        std::vector<size_t> faceBase(nc + 1, 0);
+        for (size_t c = 0; c < nc; ++c) {
+            const ObjData &d = chunks[c].data;
+            posBase[c + 1] = posBase[c] + d.positions.size();
+            nrmBase[c + 1] = nrmBase[c] + d.normals.size();
+            idxBase[c + 1] = idxBase[c] + d.posIdx.size();
+            triBase[c + 1] = triBase[c] + d.faceMatIds.size();
+            faceBase[c + 1] = faceBase[c] + d.faceCount;
+            out.texcoordCount += d.texcoordCount;
+        }
+
+        // 재질 이름을 전역 순서로 합치고, 청크 앞부분이 이어받을 재질을 계산
+        std::vector<std::vector<int>> matRemap(nc);
+        std::vector<int> inherited(nc, -1);
+        int cur = -1;
+        for (size_t c = 0; c < nc; ++c) {
+            ObjData &d = chunks[c].data;
+            for (const auto &name : d.matNames) {
+                auto it = std::find(out.matNames.begin(), out.matNames.end(), name);
+                matRemap[c].push_back(static_cast<int>(it - out.matNames.begin()));
+                if (it == out.matNames.end()) out.matNames.push_back(name);
+            }
+            for (auto &lib : d.mtlLibs) out.mtlLibs.push_back(std::move(lib));
+            inherited[c] = cur;
+            if (chunks[c].lastMat >= 0) cur = matRemap[c][chunks[c].lastMat];
+        }
+
+        out.positions.resize(posBase[nc]);
+        out.normals.resize(nrmBase[nc]);
+        out.posIdx.resize(idxBase[nc]);
+        out.nrmIdx.resize(idxBase[nc]);
+        out.faceMatIds.resize(triBase[nc]);
+        out.faceIds.resize(triBase[nc]);
+        out.faceCount = faceBase[nc];
+
+        std::atomic<bool> bad{false};
+        parallel::forEachTask(nc, [&](size_t c) {
+            Chunk &ch = chunks[c];
+            ObjData &d = ch.data;
+            std::copy(d.positions.begin(), d.positions.end(), out.positions.begin() + posBase[c]);
+            std::copy(d.normals.begin(), d.normals.end(), out.normals.begin() + nrmBase[c]);
+
+            for (size_t s : ch.relPos) {
+                int64_t v = static_cast<int64_t>(posBase[c]) + static_cast<int32_t>(d.posIdx[s]);
+                if (v < 0) bad = true;
+                d.posIdx[s] = static_cast<uint32_t>(v);
+            }
+            for (size_t s : ch.relNrm) {
+                int64_t n = static_cast<int64_t>(nrmBase[c]) + d.nrmIdx[s];
+                if (n < 0) bad = true;
+                d.nrmIdx[s] = static_cast<int32_t>(n);
+            }
+            std::copy(d.posIdx.begin(), d.posIdx.end(), out.posIdx.begin() + idxBase[c]);
+            std::copy(d.nrmIdx.begin(), d.nrmIdx.end(), out.nrmIdx.begin() + idxBase[c]);
+
+            int *mat = out.faceMatIds.data() + triBase[c];
+            for (size_t f = 0; f < d.faceMatIds.size(); ++f) {
+                int id = d.faceMatIds[f];
+                mat[f] = (id == kInheritMat) ? inherited[c] : matRemap[c][id];
+            }
+            uint32_t *face = out.faceIds.data() + triBase[c];
+            for (size_t f = 0; f < d.faceIds.size(); ++f)
+                face[f] = static_cast<uint32_t>(faceBase[c] + d.faceIds[f]);
+            d = ObjData(); // 복사가 끝난 청크는 바로 해제 (peak 메모리 감소)
+        });
+        if (bad) err = "invalid relative face index";
+        return !bad;
+    }
+}
+
+namespace {
+    inline void growBounds(const glm::vec3 *p, size_t n, glm::vec3 &bmin, glm::vec3 &bmax) {
+        for (size_t i = 0; i < n; ++i) {
+            bmin = glm::min(bmin, p[i]);
+            bmax = glm::max(bmax, p[i]);
+        }
+    }
+
+    /// 병렬 파싱 중 "앞에서부터 연속으로 끝난 청크" 만 미리보기로 내보냄.
+    /// 앞 청크들의 정점 수가 확정돼야 상대 인덱스와 청크 간 참조를 풀 수 있기 때문
+    struct PreviewPublisher {
+        const ObjParser::Preview &cb;
+        std::vector<Chunk> &chunks;
+        std::mutex m;
+        std::vector<char> done;
+        std::vector<size_t> posBase{0}; // 내보낸 청크들의 정점 시작 위치
+        size_t next = 0;
+        bool active = true;
+        glm::vec3 bmin{1e9f}, bmax{-1e9f};
+        std::vector<glm::vec3> corners;
+
+        PreviewPublisher(const ObjParser::Preview &cb, std::vector<Chunk> &chunks)
+            : cb(cb), chunks(chunks), done(chunks.size(), 0) {}
+
+        const glm::vec3 *position(size_t g) const {
+            if (g >= posBase.back()) return nullptr; // 아직 내보내지 않은 정점
+            size_t c = std::upper_bound(posBase.begin(), posBase.end(), g) - posBase.begin() - 1;
+            return &chunks[c].data.positions[g - posBase[c]];
+        }
+
+        void chunkDone(size_t c) {
+            std::lock_guard<std::mutex> lock(m);
+            done[c] = 1;
+            for (; next < chunks.size() && done[next]; ++next) {
+                Chunk &ch = chunks[next];
+                const ObjData &d = ch.data;
+                size_t base = posBase.back();
+                posBase.push_back(base + d.positions.size());
+                if (!ch.ok) active = false;
+                if (!active) continue;
+                if (posBase.back() == 0) continue; // 정점이 하나도 없으면 bbox 가 초기값 (1e9, -1e9) 그대로
+
+                growBounds(d.positions.data(), d.positions.size(), bmin, bmax);
+                corners.clear();
+                size_t rel = 0;
+                for (size_t t = 0; t < d.posIdx.size() / 3; ++t) {
+                    const glm::vec3 *p[3];
+                    bool ok = true;
+                    for (int k = 0; k < 3; ++k) {
+                        size_t s = 3 * t + k;
+                        int64_t g = d.posIdx[s];
+                        if (rel < ch.relPos.size() && ch.relPos[rel] == s) {
+                            g = static_cast<int64_t>(base) + static_cast<int32_t>(d.posIdx[s]);
+                            ++rel;
+                        }
+                        p[k] = g >= 0 ? position(static_cast<size_t>(g)) : nullptr;
+                        ok = ok && p[k];
+                    }
+                    if (ok) corners.insert(corners.end(), {*p[0], *p[1], *p[2]});
+                }
+                active = cb(corners, bmin, bmax);
+            }
+        }
+    };
+}
+
+// ---------------------------------------------------------------------------
+// ObjParser
+// ---------------------------------------------------------------------------
+bool ObjParser::parse(const char *begin, const char *end, ObjData &out,
+                      std::string &err, const Options &opt) {
+    const unsigned threads = opt.threads ? opt.threads : parallel::threadCount();
+    const size_t size = static_cast<size_t>(end - begin);
+
+    // 작은 파일은 스레드를 띄우는 비용이 더 큼 → 단일 스레드로 바로 out 에 씀
+    if (threads <= 1 || size < kParallelThreshold) {
+        // 진행률 tick 마다 그 사이에 끝난 삼각형을 미리보기로 내보냄 (같은 스레드라 out 을 바로 읽음)
+        size_t sentTri = 0, seenPos = 0;
+        bool previewing = static_cast<bool>(opt.preview);
+        glm::vec3 bmin(1e9f), bmax(-1e9f);
+        std::vector<glm::vec3> corners;
+        Progress tick;
+        if (opt.progress || previewing) {
+            tick = [&](size_t bytes) {
+                // 첫 tick (0 바이트) 처럼 아직 정점이 없으면 bbox 가 초기값이라 내보내지 않음
+                if (previewing && !out.positions.empty()) {
+                    growBounds(out.positions.data() + seenPos, out.positions.size() - seenPos, bmin, bmax);
+                    seenPos = out.positions.size();
+                    corners.clear();
+                    for (size_t t = sentTri; t < out.posIdx.size() / 3; ++t) {
+                        const uint32_t *i = &out.posIdx[3 * t];
+                        if (i[0] < seenPos && i[1] < seenPos && i[2] < seenPos)
+                            corners.insert(corners.end(), {out.positions[i[0]], out.positions[i[1]], out.positions[i[2]]});
+                    }
+                    sentTri = out.posIdx.size() / 3;
+                    previewing = opt.preview(corners, bmin, bmax);
+                }
+                return opt.progress ? opt.progress(bytes) : true;
+            };
+        }
+
+        const char *errAt = nullptr;
+        if (!parseRange(begin, end, out, opt.triangulate, nullptr, tick, err, errAt)) {
+            err = lineMessage(begin, errAt, err);
+            return false;
+        }
+        return validate(out, err);
+    }
+
+    // 줄 경계에 맞춘 청크로 분할. 코어당 여러 개로 나눠 작업량 불균형을 흡수
+    const size_t target = std::max<size_t>(size / (threads * 8), size_t(1) << 20);
+    std::vector<Chunk> chunks;
+    for (const char *p = begin; p < end;) {
+        const char *e = (static_cast<size_t>(end - p) <= target) ? end : p + target;
+        if (e < end) {
+            const char *nl = static_cast<const char *>(std::memchr(e, '\n', end - e));
+            e = nl ? nl + 1 : end;
+        }
+        Chunk ch;
+        ch.begin = p;
+        ch.end = e;
+        chunks.push_back(std::move(ch));
+        p = e;
+    }
+
+    std::unique_ptr<PreviewPublisher> publisher;
+    if (opt.preview) publisher = std::make_unique<PreviewPublisher>(opt.preview, chunks);
+
+    parallel::forEachTask(chunks.size(), [&](size_t c) {
+        Chunk &ch = chunks[c];
+        ch.ok = parseRange(ch.begin, ch.end, ch.data, opt.triangulate, &ch, opt.progress, ch.err, ch.errAt);
+        if (publisher) publisher->chunkDone(c);
+    });
+    for (const Chunk &ch : chunks)
+        if (!ch.ok) {
+            err = lineMessage(begin, ch.errAt, ch.err);
+            return false;
+        }
+
+    return mergeChunks(chunks, out, err) && validate(out, err);
+}
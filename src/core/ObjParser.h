@@ -0,0 +1,55 @@
+#ifndef OBJPARSER_H
+#define OBJPARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "MappedFile.h"
+
+/// OBJ 파싱 결과 – face 는 삼각형 코너 단위로 풀어서 저장
+struct ObjData {
+    std::vector<glm::vec3> positions;  // v
+    std::vector<glm::vec3> normals;    // vn
+    size_t texcoordCount = 0;          // vt (개수만 셈, 값은 사용하지 않음)
+
+    std::vector<uint32_t> posIdx;      // 코너별 v 인덱스 (0‑based, 3‑배수)
+    std::vector<int32_t> nrmIdx;       // 코너별 vn 인덱스, 없으면 -1
+    std::vector<int> faceMatIds;       // 삼각형별 matNames 인덱스, 없으면 -1
+    std::vector<uint32_t> faceIds;     // 삼각형별 f 문 번호 (0‑based, 다각형은 fan 삼각형이 같은 번호)
+    size_t faceCount = 0;              // f 문 수 (선분 / 점으로 버린 것 포함, 파일의 f 번호와 맞춤)
+
+    std::vector<std::string> mtlLibs;  // mtllib 파일 이름들
+    std::vector<std::string> matNames; // usemtl 에 등장한 이름 (등장 순서)
+};
+
+namespace ObjParser {
+    /// 이 크기보다 작은 파일은 단일 스레드로 파싱
+    constexpr size_t kParallelThreshold = size_t(4) << 20;
+
+    /// 약 1 MB 마다 새로 처리한 바이트 수로 호출 (여러 스레드에서 동시에 불릴 수 있음).
+    /// false 를 돌려주면 파싱을 중단하고 err = "cancelled"
+    using Progress = std::function<bool(size_t bytes)>;
+
+    /// 파싱이 끝난 앞부분의 삼각형을 파일 순서대로 넘김 (스트리밍 미리보기용).
+    /// corners 는 삼각형당 위치 3개, bmin/bmax 는 지금까지 읽은 정점 전체의 bbox.
+    /// 호출은 직렬화되며 false 를 돌려주면 더 이상 부르지 않음
+    using Preview = std::function<bool(const std::vector<glm::vec3> &corners,
+                                       const glm::vec3 &bmin, const glm::vec3 &bmax)>;
+
+    struct Options {
+        bool triangulate = true;  // false 이면 다각형은 첫 삼각형만 사용 (기존 tinyobj 경로와 동일)
+        unsigned threads = 0;     // 0 이면 하드웨어 스레드 수 만큼
+        Progress progress;
+        Preview preview;
+    };
+
+    /// [begin, end) 범위의 OBJ 텍스트를 v / vn / vt / f 단위로 토큰화.
+    /// 큰 파일은 줄 경계에 맞춘 청크로 나눠 모든 코어에서 파싱한 뒤 prefix sum 으로 병합
+    bool parse(const char *begin, const char *end, ObjData &out,
+               std::string &err, const Options &opt = {});
+}
+
+#endif //OBJPARSER_H
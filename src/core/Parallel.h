@@ -0,0 +1,119 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+/// std::thread 기반 간단한 병렬 루프 (외부 의존성 없음)
+namespace parallel {
+    inline unsigned threadCount() {
+        unsigned n = std::thread::hardware_concurrency();
+        return n ? n : 1;
+    }
+
+    /// [0, n) 을 균등한 구간으로 나누어 fn(begin, end) 를 각 스레드에서 실행.
+    /// 구간이 minGrain 보다 작아지면 스레드를 덜 씀
+    template<class F>
+    void forRange(size_t n, F &&fn, size_t minGrain = 4096) {
+        if (n == 0) return;
+        size_t threads = std::min<size_t>(threadCount(), (n + minGrain - 1) / minGrain);
+        if (threads <= 1) { fn(size_t(0), n); return; }
+
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        size_t step = (n + threads - 1) / threads;
+        for (size_t t = 1; t < threads; ++t) {
+            size_t b = t * step, e = std::min(n, b + step);
+            if (b >= e) break;
+            pool.emplace_back([&fn, b, e] { fn(b, e); });
+        }
+        fn(size_t(0), std::min(n, step)); // 첫 구간은 호출 스레드가 처리
+        for (auto &th : pool) th.join();
+    }
+
+    /// 작업 0..n-1 을 원자 카운터로 나눠 가지며 fn(i) 실행 (작업 크기가 불균등할 때)
+    template<class F>
+    void forEachTask(size_t n, F &&fn) {
+        if (n == 0) return;
+        size_t threads = std::min<size_t>(threadCount(), n);
+        std::atomic<size_t> next{0};
+        auto worker = [&] {
+            for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < n;)
+                fn(i);
+        };
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        for (size_t t = 1; t < threads; ++t) pool.emplace_back(worker);
+        worker();
+        for (auto &th : pool) th.join();
+    }
+
+    /// keys[i] 가 같은 i 끼리 모은 CSR: items[offset[k], offset[k + 1]) 에 keys[i] == k 인 item(i) 가 i 오름차순으로.
+    /// 키 상위 비트로 나눈 버킷 단위 2단계 카운팅 정렬: 스레드별 구간에서 버킷 히스토그램 → scan → 버킷으로 분배,
+    /// 그 다음 버킷마다 (자기 키 구간만) 카운팅 정렬. atomic 없이 직렬 카운팅 정렬과 같은 결과
+    template<class F>
+    void groupByKey(const uint32_t *keys, size_t n, size_t keyCount,
+                    std::vector<uint32_t> &offset, std::vector<uint32_t> &items, F &&item,
+                    size_t minGrain = size_t(1) << 16) {
+        offset.assign(keyCount + 1, 0);
+        items.resize(n);
+        const size_t parts = std::min<size_t>(threadCount(), n / minGrain);
+        if (parts <= 1 || keyCount == 0) {
+            for (size_t i = 0; i < n; ++i) ++offset[keys[i] + 1];
+            for (size_t k = 0; k < keyCount; ++k) offset[k + 1] += offset[k];
+            std::vector<uint32_t> cursor(offset.begin(), offset.end() - 1);
+            for (size_t i = 0; i < n; ++i) items[cursor[keys[i]]++] = item(i);
+            return;
+        }
+
+        // 1) 버킷 = 키 >> shift (최대 4096 개). 스레드 p 의 구간에서 버킷별 개수 → 버킷 우선 scan 으로 쓸 위치
+        unsigned shift = 0;
+        while (((keyCount - 1) >> shift) >= 4096) ++shift;
+        const size_t buckets = ((keyCount - 1) >> shift) + 1;
+        const size_t step = (n + parts - 1) / parts;
+        std::vector<uint32_t> pos(parts * buckets, 0), bucketStart(buckets + 1);
+        forEachTask(parts, [&](size_t p) {
+            uint32_t *hist = &pos[p * buckets];
+            for (size_t i = p * step, e = std::min(n, i + step); i < e; ++i) ++hist[keys[i] >> shift];
+        });
+        uint32_t sum = 0;
+        for (size_t b = 0; b < buckets; ++b) {
+            bucketStart[b] = sum;
+            for (size_t p = 0; p < parts; ++p) {
+                uint32_t count = pos[p * buckets + b];
+                pos[p * buckets + b] = sum;
+                sum += count;
+            }
+        }
+        bucketStart[buckets] = sum;
+
+        // 2) 원소 번호를 버킷으로 분배 (버킷 안에서는 스레드 순 = i 오름차순)
+        forEachTask(parts, [&](size_t p) {
+            uint32_t *cursor = &pos[p * buckets];
+            for (size_t i = p * step, e = std::min(n, i + step); i < e; ++i)
+                items[cursor[keys[i] >> shift]++] = static_cast<uint32_t>(i);
+        });
+
+        // 3) 버킷마다 자기 키 구간 [kb, ke) 의 offset 을 채우고 그 자리에서 키 순으로 다시 배치
+        forEachTask(buckets, [&](size_t b) {
+            const size_t kb = b << shift, ke = std::min(keyCount, kb + (size_t(1) << shift));
+            const std::vector<uint32_t> members(items.begin() + bucketStart[b], items.begin() + bucketStart[b + 1]);
+            for (uint32_t i : members) ++offset[keys[i]];
+            uint32_t at = bucketStart[b];
+            for (size_t k = kb; k < ke; ++k) {
+                uint32_t count = offset[k];
+                offset[k] = at;
+                at += count;
+            }
+            std::vector<uint32_t> cursor(offset.begin() + kb, offset.begin() + ke);
+            for (uint32_t i : members) items[cursor[keys[i] - kb]++] = item(i);
+        });
+        offset[keyCount] = static_cast<uint32_t>(n);
+    }
+}
+
+#endif //PARALLEL_H
@@ -0,0 +1,85 @@
+#include "ProcessMemory.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <sys/resource.h>
+#elif defined(__linux__)
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#endif
+
+#ifdef __linux__
+namespace {
+    /// /proc/self/status 의 "key: N kB" 한 줄
+    size_t statusKb(const char *key) {
+        std::FILE *f = std::fopen("/proc/self/status", "r");
+        if (!f) return 0;
+        char line[256];
+        size_t kb = 0;
+        const size_t n = std::strlen(key);
+        while (std::fgets(line, sizeof line, f)) {
+            if (std::strncmp(line, key, n) == 0 && line[n] == ':') {
+                kb = std::strtoull(line + n + 1, nullptr, 10);
+                break;
+            }
+        }
+        std::fclose(f);
+        return kb;
+    }
+}
+#endif
+
+namespace procmem {
+    size_t currentRss() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS pmc{};
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof pmc)) return 0;
+        return pmc.WorkingSetSize;
+#elif defined(__APPLE__)
+        mach_task_basic_info info{};
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+        if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) !=
+            KERN_SUCCESS)
+            return 0;
+        return info.resident_size;
+#elif defined(__linux__)
+        return statusKb("VmRSS") * 1024;
+#else
+        return 0;
+#endif
+    }
+
+    size_t peakRss() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS pmc{};
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof pmc)) return 0;
+        return pmc.PeakWorkingSetSize;
+#elif defined(__APPLE__)
+        rusage ru{};
+        if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+        return static_cast<size_t>(ru.ru_maxrss); // macOS 는 바이트 단위
+#elif defined(__linux__)
+        return statusKb("VmHWM") * 1024;
+#else
+        return 0;
+#endif
+    }
+
+    bool resetPeak() {
+#ifdef __linux__
+        // "5" = VmHWM 을 현재 RSS 로 (커널 4.0+)
+        std::FILE *f = std::fopen("/proc/self/clear_refs", "w");
+        if (!f) return false;
+        const bool ok = std::fputs("5", f) >= 0;
+        return std::fclose(f) == 0 && ok;
+#else
+        return false;
+#endif
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef PROCESSMEMORY_H
+#define PROCESSMEMORY_H
+
+#include <cstddef>
+
+/// 프로세스 상주 메모리 (RSS, 바이트). 모르는 플랫폼이면 0.
+/// mmap 한 OBJ 파일 중 읽은 페이지도 RSS 에 들어감
+namespace procmem {
+    size_t currentRss();
+
+    /// 마지막 resetPeak() 이후 최대 RSS (리셋을 지원하지 않으면 프로세스 시작 이후)
+    size_t peakRss();
+
+    /// 최대값을 지금 RSS 로 되돌림. Linux 만 지원 (/proc/self/clear_refs), 아니면 false
+    bool resetPeak();
+}
+
+#endif //PROCESSMEMORY_H
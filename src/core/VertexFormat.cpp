@@ -0,0 +1,48 @@
+#include "VertexFormat.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+
+namespace VertexPacking {
+    int16_t toSnorm16(float v) {
+        if (!(v == v)) return 0; // NaN
+        float c = std::clamp(v, -1.0f, 1.0f);
+        return static_cast<int16_t>(std::lround(c * 32767.0f));
+    }
+
+    glm::vec2 octEncode(const glm::vec3 &n) {
+        float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+        if (!(l1 > 0.0f)) return {0.0f, 0.0f}; // 0 벡터 / NaN 은 +Z 로
+        glm::vec2 p(n.x / l1, n.y / l1);
+        if (n.z < 0.0f) {
+            // 아래쪽 반구는 대각선 기준으로 접어서 바깥 삼각형에 배치
+            glm::vec2 s(p.x >= 0.0f ? 1.0f : -1.0f, p.y >= 0.0f ? 1.0f : -1.0f);
+            p = glm::vec2((1.0f - std::abs(p.y)) * s.x, (1.0f - std::abs(p.x)) * s.y);
+        }
+        return p;
+    }
+
+    glm::vec3 octDecode(const glm::vec2 &e) {
+        glm::vec3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+        float t = std::max(-n.z, 0.0f);
+        n.x += n.x >= 0.0f ? -t : t;
+        n.y += n.y >= 0.0f ? -t : t;
+        return glm::normalize(n);
+    }
+
+    std::vector<PackedVertex> pack(const std::vector<Vertex> &vertices,
+                                   const glm::vec3 &center, float extent) {
+        std::vector<PackedVertex> out(vertices.size());
+        const float inv = extent > 0.0f ? 1.0f / dequantScale(extent) : 0.0f;
+        parallel::forRange(vertices.size(), [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                const Vertex &v = vertices[i];
+                glm::vec3 q = (v.position - center) * inv;
+                glm::vec2 o = octEncode(v.normal);
+                out[i] = {{toSnorm16(q.x), toSnorm16(q.y), toSnorm16(q.z), 0},
+                          {toSnorm16(o.x), toSnorm16(o.y)}};
+            }
+        }, 1 << 16);
+        return out;
+    }
+}
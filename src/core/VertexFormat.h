@@ -0,0 +1,42 @@
+#ifndef VERTEXFORMAT_H
+#define VERTEXFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ModelLoader.h"
+
+/// 모델 VBO 에 올리는 정점 레이아웃
+enum class VertexFormat {
+    Float32, // Vertex 그대로 (32 B: 위치·노멀·UV float)
+    Packed   // PackedVertex (12 B: snorm16 위치 + 옥타헤드럴 snorm16 노멀, UV 없음)
+};
+
+/// 위치는 (p - center) / (extent / 2) 를 snorm16 으로 (w 는 4바이트 정렬용),
+/// 노멀은 옥타헤드럴 매핑한 2D 좌표를 snorm16 으로 저장
+struct PackedVertex {
+    int16_t position[4];
+    int16_t normal[2];
+};
+static_assert(sizeof(PackedVertex) == 12, "PackedVertex must stay tightly packed");
+
+namespace VertexPacking {
+    /// [-1, 1] → snorm16 (GL 의 정규화 규칙 c / 32767 과 짝)
+    int16_t toSnorm16(float v);
+
+    /// 단위 벡터 → 옥타헤드럴 [-1, 1]²
+    glm::vec2 octEncode(const glm::vec3 &n);
+
+    /// octEncode 의 역변환 (phong.vert 의 octDecode 와 같은 식)
+    glm::vec3 octDecode(const glm::vec2 &e);
+
+    /// vertices 를 center / extent 기준으로 양자화 (큰 배열은 병렬)
+    std::vector<PackedVertex> pack(const std::vector<Vertex> &vertices,
+                                   const glm::vec3 &center, float extent);
+
+    /// 양자화 위치를 모델 좌표로 되돌리는 배율 (= extent / 2). 셰이더에서는 uModel 에 합쳐서 처리
+    inline float dequantScale(float extent) { return 0.5f * extent; }
+}
+
+#endif //VERTEXFORMAT_H
@@ -1,6 +1,9 @@
 #include <QApplication>
 #include <QSurfaceFormat>
+#include <algorithm>
+#include <cstring>
 
+#include "Renderer/RenderBench.h"
 #include "ui/MainWindow.h"
 int main(int argc, char *argv[]) {
     QSurfaceFormat fmt;
@@ -9,7 +12,16 @@ int main(int argc, char *argv[]) {
     fmt.setDepthBufferSize(24);
     QSurfaceFormat::setDefaultFormat(fmt);    // ★ 모든 위젯에 적용
 
+    // --bench-render: 창 없이 렌더링 벤치마크만 돌리고 종료 (디스플레이 없는 CI / 렌더 노드)
+    const bool benchRender = std::any_of(argv + 1, argv + argc, [](const char *a) {
+        return std::strcmp(a, "--bench-render") == 0;
+    });
+    if (benchRender && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
     QApplication app(argc, argv);
+    if (benchRender)
+        return RenderBench::run(QApplication::arguments());
 
     MainWindow win;
     win.resize(1200, 800);
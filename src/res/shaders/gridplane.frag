@@ -0,0 +1,29 @@
+#version 330 core
+uniform vec4 uColor;
+uniform float uStep;      // 가는 선 간격 (굵은 선은 10칸마다)
+uniform float uLineWidth; // 선 굵기 (월드 단위)
+uniform vec3 uEye;
+uniform float uFadeDist;  // 카메라에서 이 거리면 완전히 사라짐
+in vec3 vWorld;
+out vec4 FragColor;
+
+// 칸 단위 좌표 p 의 격자선 coverage. px = fwidth(p), width = 칸 단위 선 굵기.
+// 픽셀보다 가는 선은 1픽셀 폭으로 그리되 그만큼 흐리게, 칸이 몇 픽셀 안 되게 작아지면 통째로 흐려짐 (moiré 방지)
+float lines(vec2 p, vec2 px, float width) {
+    vec2 d = abs(fract(p - 0.5) - 0.5); // 가장 가까운 선까지 거리
+    vec2 w = max(vec2(width), px);
+    vec2 cov = (1.0 - smoothstep(0.5 * (w - px), 0.5 * (w + px), d)) * min(vec2(width) / w, 1.0);
+    float lod = 1.0 - smoothstep(0.1, 0.3, max(px.x, px.y));
+    return max(cov.x, cov.y) * lod;
+}
+
+void main() {
+    // 굵은 격자는 좌표 / 미분 / 굵기를 1/10 로 줄이면 되므로 fwidth 는 한 번만 (소프트웨어 GL 에서 화면 전체가 이 셰이더)
+    vec2 p = vWorld.xz / uStep;
+    vec2 px = fwidth(p);
+    float width = uLineWidth / uStep;
+    float a = max(lines(p, px, width), lines(p * 0.1, px * 0.1, width * 0.1));
+    a *= 1.0 - smoothstep(0.5 * uFadeDist, uFadeDist, distance(vWorld, uEye));
+    if (a < 0.01) discard; // 선 사이는 깊이도 안 씀 (평면 아래 모델이 가려지지 않게)
+    FragColor = vec4(uColor.rgb, uColor.a * a);
+}
@@ -0,0 +1,12 @@
+#version 330 core
+// 정점 버퍼 없이 gl_VertexID 로 y = uHeight 평면 위 정사각형 (triangle strip 4개)
+uniform mat4 uPV;
+uniform float uHalfSize;
+uniform float uHeight;
+out vec3 vWorld;
+void main() {
+    vec2 c = vec2((gl_VertexID & 1) == 0 ? -1.0 : 1.0,
+                  (gl_VertexID & 2) == 0 ? -1.0 : 1.0) * uHalfSize;
+    vWorld = vec3(c.x, uHeight, c.y);
+    gl_Position = uPV * vec4(vWorld, 1.0);
+}
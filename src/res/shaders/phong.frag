@@ -7,11 +7,14 @@ uniform vec3 uViewPos;
 uniform float uKd;      // Diffuse
 uniform float uKs;      // Specular
 uniform float uShin;    // shininess
+uniform bool uFlat;     // true = 면 노멀 (Face 모드)
 
 out vec4 FragColor;
 
 void main() {
-    vec3 N = normalize(vNrm);
+    // Face 모드: 화면공간 미분으로 삼각형 평면의 노멀을 구함 → 버텍스 복제 없이 flat shading
+    vec3 N = uFlat ? normalize(cross(dFdx(vPos), dFdy(vPos)))
+                   : normalize(vNrm);
     vec3 L = normalize(uLightPos - vPos);
     vec3 V = normalize(uViewPos - vPos);
     vec3 R = reflect(-L, N);
@@ -6,13 +6,23 @@ layout(location = 2) in vec2 aUV;
 uniform mat4 uModel;
 uniform mat4 uView;
 uniform mat4 uProj;
+uniform bool uOctNormals; // true = aNrm.xy 가 옥타헤드럴 인코딩 (Packed 정점)
 
 out vec3 vPos;   // world‑space
 out vec3 vNrm;
 
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
 void main() {
+    // Packed 정점의 양자화 해제(center / extent)는 uModel 에 합쳐져 있음
     vec4 worldPos = uModel * vec4(aPos, 1.0);
     vPos = worldPos.xyz;
-    vNrm = mat3(transpose(inverse(uModel))) * aNrm;
+    vec3 n = uOctNormals ? octDecode(aNrm.xy) : aNrm;
+    vNrm = mat3(transpose(inverse(uModel))) * n;
     gl_Position = uProj * uView * worldPos;
 }
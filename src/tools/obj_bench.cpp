@@ -0,0 +1,608 @@
+// obj_bench – Qt 없이 로드 파이프라인 (파싱 → 노멀 → rebuildVertices → 순서 최적화 → 노멀 모드 전환) 단계별 시간 측정.
+// 결과는 JSON, --baseline 으로 이전 결과를 주면 허용 오차를 넘는 단계가 있을 때 종료 코드 1
+#include "core/FlatIndexMap.h"
+#include "core/GeometryKernels.h"
+#include "core/MappedFile.h"
+#include "core/ModelLoader.h"
+#include "core/ObjParser.h"
+#include "core/Parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double msSince(Clock::time_point t) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+    }
+
+    const char *const kDefaultModels[] = {"bunny.obj", "cow.obj", "pumpkin.obj", "teapot.obj", "teddybear.obj"};
+
+    // 이보다 짧은 단계는 타이머 잡음이 상대 오차를 지배하므로 회귀 판정에서 절대 차이도 같이 봄
+    constexpr double kMinRegressionMs = 0.5;
+
+    struct Options {
+        std::vector<std::string> files;
+        std::string modelDir;
+        std::string jsonPath;     // 비면 stdout
+        std::string baselinePath;
+        double tolerance = 0.15;  // 기준 중앙값 대비 허용 증가율
+        int warmup = 2;
+        int reps = 10;
+        MeshOrder order = MeshOrder::FirstUse;
+        bool optimizeOrder = false; // 정점 캐시용 삼각형 재배치 (ModelLoader::setOptimizeIndexOrder)
+        unsigned threads = 0;     // 파싱 스레드 수, 0 이면 하드웨어 스레드 수
+        bool micro = false;
+    };
+
+    unsigned parseThreads(const Options &opt) {
+        return opt.threads ? opt.threads : parallel::threadCount();
+    }
+
+    const char *orderName(MeshOrder order) {
+        return order == MeshOrder::Morton ? "morton" : "first-use";
+    }
+
+    void usage() {
+        std::cerr <<
+            "usage: obj_bench [options] [model.obj ...]\n"
+            "  --models DIR       bundled models directory (default: <exe dir>/res/models)\n"
+            "  --warmup N         untimed runs per model (default 2)\n"
+            "  --reps N           timed runs per model (default 10)\n"
+            "  --json FILE        write results to FILE instead of stdout\n"
+            "  --baseline FILE    compare medians with a previous --json result\n"
+            "  --tolerance X      allowed slowdown vs baseline, 0.15 = 15% (default)\n"
+            "  --order ORDER      vertex order after dedup: first-use (default) or morton\n"
+            "  --optimize-order   also reorder triangles for the vertex cache (the 'optimize' stage)\n"
+            "  --threads N        parser threads for the pipeline runs and the speedup check (default: all)\n"
+            "  --micro            also run dedup / SIMD kernel microbenchmarks\n";
+    }
+
+    // ---- 통계 ----
+
+    struct Summary {
+        double min = 0.0, median = 0.0, mean = 0.0;
+    };
+
+    Summary summarize(std::vector<double> v) {
+        Summary s;
+        if (v.empty()) return s;
+        std::sort(v.begin(), v.end());
+        s.min = v.front();
+        s.median = v.size() % 2 ? v[v.size() / 2] : 0.5 * (v[v.size() / 2 - 1] + v[v.size() / 2]);
+        double sum = 0.0;
+        for (double x : v) sum += x;
+        s.mean = sum / v.size();
+        return s;
+    }
+
+    /// fn 을 warmup 번 버리고 reps 번 잰 시간 (ms)
+    template<class F>
+    std::vector<double> timeRuns(int warmup, int reps, F &&fn) {
+        for (int i = 0; i < warmup; ++i) fn();
+        std::vector<double> ms;
+        for (int i = 0; i < reps; ++i) {
+            auto t = Clock::now();
+            fn();
+            ms.push_back(msSince(t));
+        }
+        return ms;
+    }
+
+    // ---- 최소 JSON (출력 + 기준 파일 읽기) ----
+
+    struct Json {
+        enum Type { Null, Number, String, Array, Object } type = Null;
+        double number = 0.0;
+        std::string string;
+        std::vector<Json> array;
+        std::vector<std::pair<std::string, Json>> object;
+
+        const Json *find(const std::string &key) const {
+            for (const auto &[k, v] : object)
+                if (k == key) return &v;
+            return nullptr;
+        }
+    };
+
+    /// 숫자 / 문자열 / 배열 / 객체 / true·false·null 만 (이 도구가 쓴 파일을 다시 읽는 용도)
+    class JsonReader {
+    public:
+        explicit JsonReader(const std::string &text) : p_(text.data()), end_(text.data() + text.size()) {}
+
+        bool parse(Json &out) {
+            if (!value(out)) return false;
+            skip();
+            return p_ == end_;
+        }
+
+    private:
+        void skip() {
+            while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) ++p_;
+        }
+
+        bool literal(const char *word) {
+            size_t n = std::strlen(word);
+            if (size_t(end_ - p_) < n || std::strncmp(p_, word, n) != 0) return false;
+            p_ += n;
+            return true;
+        }
+
+        bool str(std::string &out) {
+            if (p_ >= end_ || *p_ != '"') return false;
+            for (++p_; p_ < end_ && *p_ != '"'; ++p_) {
+                if (*p_ == '\\' && p_ + 1 < end_) ++p_; // 이스케이프는 다음 글자 그대로
+                out.push_back(*p_);
+            }
+            if (p_ >= end_) return false;
+            ++p_;
+            return true;
+        }
+
+        bool value(Json &out) {
+            skip();
+            if (p_ >= end_) return false;
+            if (*p_ == '{') {
+                out.type = Json::Object;
+                ++p_;
+                skip();
+                if (p_ < end_ && *p_ == '}') { ++p_; return true; }
+                for (;;) {
+                    std::string key;
+                    skip();
+                    if (!str(key)) return false;
+                    skip();
+                    if (p_ >= end_ || *p_++ != ':') return false;
+                    Json v;
+                    if (!value(v)) return false;
+                    out.object.emplace_back(std::move(key), std::move(v));
+                    skip();
+                    if (p_ < end_ && *p_ == ',') { ++p_; continue; }
+                    if (p_ < end_ && *p_ == '}') { ++p_; return true; }
+                    return false;
+                }
+            }
+            if (*p_ == '[') {
+                out.type = Json::Array;
+                ++p_;
+                skip();
+                if (p_ < end_ && *p_ == ']') { ++p_; return true; }
+                for (;;) {
+                    Json v;
+                    if (!value(v)) return false;
+                    out.array.push_back(std::move(v));
+                    skip();
+                    if (p_ < end_ && *p_ == ',') { ++p_; continue; }
+                    if (p_ < end_ && *p_ == ']') { ++p_; return true; }
+                    return false;
+                }
+            }
+            if (*p_ == '"') {
+                out.type = Json::String;
+                return str(out.string);
+            }
+            if (literal("true")) { out.type = Json::Number; out.number = 1.0; return true; }
+            if (literal("false")) { out.type = Json::Number; out.number = 0.0; return true; }
+            if (literal("null")) { out.type = Json::Null; return true; }
+            char *e = nullptr;
+            out.number = std::strtod(p_, &e);
+            if (e == p_) return false;
+            out.type = Json::Number;
+            p_ = e;
+            return true;
+        }
+
+        const char *p_, *end_;
+    };
+
+    std::string quote(const std::string &s) {
+        std::string out = "\"";
+        for (char c : s) {
+            if (c == '"' || c == '\\') out.push_back('\\');
+            out.push_back(c);
+        }
+        return out + "\"";
+    }
+
+    // ---- 파이프라인 벤치마크 ----
+
+    const char *const kStages[] = {"parse", "normals", "vertices", "optimize", "clusters", "toggle", "total"};
+    constexpr size_t kStageCount = std::size(kStages);
+    constexpr size_t kOptimizeStage = 3, kTotalStage = kStageCount - 1;
+
+    struct ModelResult {
+        std::string name;
+        size_t triangles = 0, vertices = 0;
+        Summary stages[kStageCount];
+        MeshOrderStats order;            // 마지막 실행의 순서 재배치 전후 지표
+        size_t bytes = 0;                // OBJ 파일 크기
+        Summary parseOne, parseN;        // 파싱만: 1 스레드 / parseThreads 스레드
+        std::vector<MemoryEntry> memory; // 마지막 실행의 배열별 바이트
+        size_t leanBytes = 0;            // releaseUploadData() 뒤 합계
+        LoadMemory loadMemory;
+    };
+
+    /// 같은 파일을 1 스레드와 parseThreads 스레드로 파싱만 해서 속도 향상 측정
+    bool benchParseScaling(const std::string &path, const Options &opt, ModelResult &out) {
+        MappedFile file;
+        if (!file.open(path)) {
+            std::cerr << "obj_bench: cannot open " << path << "\n";
+            return false;
+        }
+        out.bytes = file.size();
+        auto parseWith = [&](unsigned threads) {
+            ObjParser::Options po;
+            po.threads = threads;
+            return summarize(timeRuns(opt.warmup, opt.reps, [&] {
+                ObjData obj;
+                std::string err;
+                ObjParser::parse(file.data(), file.data() + file.size(), obj, err, po);
+            }));
+        };
+        out.parseOne = parseWith(1);
+        out.parseN = parseWith(parseThreads(opt));
+        return true;
+    }
+
+    bool benchModel(const std::string &path, const Options &opt, ModelResult &out) {
+        out.name = std::filesystem::path(path).filename().string();
+        std::vector<double> samples[kStageCount];
+
+        for (int run = 0; run < opt.warmup + opt.reps; ++run) {
+            ModelLoader m;
+            m.setUseCache(false); // 항상 텍스트부터 (캐시 히트는 다른 측정)
+            m.setMeshOrder(opt.order);
+            m.setOptimizeIndexOrder(opt.optimizeOrder);
+            m.setParseThreads(opt.threads);
+            if (!m.load(path)) {
+                std::cerr << "obj_bench: cannot load " << path << "\n";
+                return false;
+            }
+            // 노멀 모드 전환 왕복 (지금은 셰이더 uniform 만 바뀌므로 거의 0 이어야 정상)
+            auto t = Clock::now();
+            m.setNormalMode(NormalMode::Face);
+            m.setNormalMode(NormalMode::Vertex);
+            const double toggle = msSince(t);
+
+            out.triangles = m.indices().size() / 3;
+            out.vertices = m.vertices().size();
+            out.order = m.orderStats();
+            out.memory = m.memoryUsage();
+            out.loadMemory = m.loadMemory();
+            m.releaseUploadData();
+            out.leanBytes = m.memoryBytes();
+            if (run < opt.warmup) continue;
+
+            const LoadTimings &lt = m.timings();
+            const double values[kStageCount] = {lt.parse, lt.normals, lt.vertices, lt.optimize, lt.clusters,
+                                                toggle, lt.total + toggle};
+            for (size_t s = 0; s < kStageCount; ++s) samples[s].push_back(values[s]);
+        }
+        for (size_t s = 0; s < kStageCount; ++s) out.stages[s] = summarize(samples[s]);
+        return benchParseScaling(path, opt, out);
+    }
+
+    // ---- --micro : 중복 제거 해시 테이블 / SIMD 커널 ----
+
+    /// 예전 std::hash<Vertex> (float 해시 8개를 1비트 시프트로 XOR – 대칭이라 규칙적인 메쉬에서 충돌)
+    struct LegacyVertexHash {
+        size_t operator()(const Vertex &v) const noexcept {
+            auto h1 = std::hash<float>()(v.position.x) ^ (std::hash<float>()(v.position.y) << 1);
+            auto h2 = std::hash<float>()(v.position.z) ^ (std::hash<float>()(v.normal.x) << 1);
+            auto h3 = std::hash<float>()(v.normal.y) ^ (std::hash<float>()(v.normal.z) << 1);
+            auto h4 = std::hash<float>()(v.texcoord.x) ^ (std::hash<float>()(v.texcoord.y) << 1);
+            return h1 ^ h2 ^ h3 ^ h4;
+        }
+    };
+
+    struct DedupResult {
+        std::string name;
+        size_t corners = 0, unique = 0;
+        double legacyMap = 0.0, unorderedMap = 0.0, flat = 0.0; // 중앙값 ms
+    };
+
+    template<class Map>
+    size_t dedupWithMap(const std::vector<Vertex> &corners) {
+        Map map;
+        map.reserve(corners.size());
+        for (const Vertex &v : corners) map.try_emplace(v, static_cast<uint32_t>(map.size()));
+        return map.size();
+    }
+
+    size_t dedupFlat(const std::vector<Vertex> &corners) {
+        FlatIndexMap<Vertex, VertexBitHash, VertexBitEqual> map(corners.size());
+        std::vector<Vertex> keys;
+        keys.reserve(corners.size());
+        for (const Vertex &v : corners) {
+            const auto next = static_cast<uint32_t>(keys.size());
+            if (map.findOrInsert(v, next, keys.data()) == next) keys.push_back(v);
+        }
+        return keys.size();
+    }
+
+    DedupResult benchDedup(const std::string &path, const Options &opt) {
+        DedupResult r;
+        r.name = std::filesystem::path(path).filename().string();
+        ModelLoader m;
+        m.setUseCache(false);
+        m.setMeshOrder(opt.order);
+        if (!m.load(path)) return r;
+        // 코너마다 완성된 정점 (rebuildVertices 가 보는 입력과 같은 분포)
+        std::vector<Vertex> corners;
+        corners.reserve(m.indices().size());
+        for (uint32_t i : m.indices()) corners.push_back(m.vertices()[i]);
+        r.corners = corners.size();
+        r.unique = dedupFlat(corners);
+
+        r.legacyMap = summarize(timeRuns(opt.warmup, opt.reps, [&] {
+            dedupWithMap<std::unordered_map<Vertex, uint32_t, LegacyVertexHash>>(corners);
+        })).median;
+        // flat 과 같은 키 (비트 단위) 로 세어야 두 숫자가 같은 작업을 잼
+        r.unorderedMap = summarize(timeRuns(opt.warmup, opt.reps, [&] {
+            dedupWithMap<std::unordered_map<Vertex, uint32_t, VertexBitHash, VertexBitEqual>>(corners);
+        })).median;
+        r.flat = summarize(timeRuns(opt.warmup, opt.reps, [&] { dedupFlat(corners); })).median;
+        return r;
+    }
+
+    struct KernelResult {
+        std::string isa;
+        double bounds = 0.0, faceNormals = 0.0, normalize = 0.0;
+    };
+
+    /// 고정 시드의 정점 1M / 삼각형 2M 에서 ISA 별 커널 시간
+    std::vector<KernelResult> benchKernels(const Options &opt) {
+        constexpr size_t kVertices = size_t(1) << 20, kTriangles = size_t(2) << 20;
+        std::mt19937 rng(12345);
+        std::uniform_real_distribution<float> coord(-1.0f, 1.0f);
+        std::uniform_int_distribution<uint32_t> vert(0, kVertices - 1);
+        std::vector<glm::vec3> pos(kVertices);
+        for (auto &p : pos) p = {coord(rng), coord(rng), coord(rng)};
+        std::vector<uint32_t> idx(kTriangles * 3);
+        for (auto &i : idx) i = vert(rng);
+
+        geom::SoA3 soa, work;
+        geom::toSoA(pos.data(), pos.size(), soa);
+        std::vector<glm::vec3> normals(kTriangles);
+
+        std::vector<KernelResult> out;
+        const geom::Isa original = geom::activeIsa();
+        for (geom::Isa isa : {geom::Isa::Scalar, geom::Isa::SSE2, geom::Isa::AVX2}) {
+            geom::setIsa(isa);
+            if (geom::activeIsa() != isa) continue; // CPU 가 지원하지 않음
+            KernelResult r;
+            r.isa = geom::isaName(isa);
+            r.bounds = summarize(timeRuns(opt.warmup, opt.reps, [&] {
+                glm::vec3 mn(1e9f), mx(-1e9f);
+                geom::bounds(soa, 0, soa.size(), mn, mx);
+            })).median;
+            r.faceNormals = summarize(timeRuns(opt.warmup, opt.reps, [&] {
+                geom::faceNormals(soa, idx.data(), 0, kTriangles, normals.data());
+            })).median;
+            r.normalize = summarize(timeRuns(opt.warmup, opt.reps, [&] {
+                work = soa;
+                geom::normalize(work, 0, work.size());
+            })).median;
+            out.push_back(r);
+        }
+        geom::setIsa(original);
+        return out;
+    }
+
+    // ---- 출력 / 기준 비교 ----
+
+    std::string toJson(const Options &opt, const std::vector<ModelResult> &models,
+                       const std::vector<DedupResult> &dedup, const std::vector<KernelResult> &kernels) {
+        std::ostringstream o;
+        o.precision(4);
+        o << std::fixed;
+        o << "{\n  \"isa\": " << quote(geom::isaName(geom::activeIsa()))
+          << ",\n  \"threads\": " << parallel::threadCount()
+          << ",\n  \"parse_threads\": " << parseThreads(opt)
+          << ",\n  \"order\": " << quote(orderName(opt.order))
+          << ",\n  \"optimize_order\": " << (opt.optimizeOrder ? "true" : "false")
+          << ",\n  \"warmup\": " << opt.warmup << ",\n  \"reps\": " << opt.reps << ",\n  \"models\": [";
+        for (size_t i = 0; i < models.size(); ++i) {
+            const ModelResult &m = models[i];
+            o << (i ? "," : "") << "\n    {\"name\": " << quote(m.name) << ", \"bytes\": " << m.bytes
+              << ", \"triangles\": " << m.triangles << ", \"vertices\": " << m.vertices << ", \"stages\": {";
+            for (size_t s = 0; s < kStageCount; ++s) {
+                o << (s ? ", " : "") << "\n      " << quote(kStages[s]) << ": {\"min\": " << m.stages[s].min
+                  << ", \"median\": " << m.stages[s].median << ", \"mean\": " << m.stages[s].mean << "}";
+            }
+            // 바이트. rss_* 는 프로세스 전체 값 (peak_is_local 이 false 면 rss_peak 는 프로세스 시작 이후 최대)
+            const LoadMemory &lm = m.loadMemory;
+            size_t total = 0;
+            const MeshOrderStats &os = m.order;
+            o << "},\n      \"order_stats\": {\"acmr_before\": " << os.acmrBefore << ", \"acmr_after\": " << os.acmrAfter
+              << ", \"atvr_before\": " << os.atvrBefore << ", \"atvr_after\": " << os.atvrAfter
+              << ", \"overfetch_before\": " << os.overfetchBefore << ", \"overfetch_after\": " << os.overfetchAfter << "}";
+            // 4 MB (ObjParser::kParallelThreshold) 미만 파일은 어느 쪽이든 단일 스레드라 1 근처가 정상
+            const double mb = m.bytes / (1024.0 * 1024.0);
+            o << ",\n      \"parse_scaling\": {\"one_thread\": " << m.parseOne.median << ", \"n_threads\": " << m.parseN.median
+              << ", \"mb_per_s_one\": " << (m.parseOne.median > 0 ? mb * 1000.0 / m.parseOne.median : 0.0)
+              << ", \"mb_per_s_n\": " << (m.parseN.median > 0 ? mb * 1000.0 / m.parseN.median : 0.0)
+              << ", \"parse_speedup\": " << (m.parseN.median > 0 ? m.parseOne.median / m.parseN.median : 0.0) << "}";
+            o << ",\n      \"memory\": {";
+            for (const MemoryEntry &e : m.memory) {
+                o << quote(e.name) << ": " << e.bytes << ", ";
+                total += e.bytes;
+            }
+            o << "\"total\": " << total << ", \"lean_total\": " << m.leanBytes << ", \"parser\": " << lm.parser << ", \"rss_before\": " << lm.rssBefore
+              << ", \"rss_peak\": " << lm.rssPeak << ", \"rss_after\": " << lm.rssAfter
+              << ", \"peak_is_local\": " << (lm.peakIsLocal ? "true" : "false") << "}}";
+        }
+        o << "\n  ]";
+        if (opt.micro) {
+            o << ",\n  \"micro\": {\n    \"dedup\": [";
+            for (size_t i = 0; i < dedup.size(); ++i) {
+                const DedupResult &d = dedup[i];
+                o << (i ? "," : "") << "\n      {\"name\": " << quote(d.name) << ", \"corners\": " << d.corners
+                  << ", \"unique\": " << d.unique << ", \"unordered_map_legacy_hash\": " << d.legacyMap
+                  << ", \"unordered_map\": " << d.unorderedMap << ", \"flat\": " << d.flat << "}";
+            }
+            o << "\n    ],\n    \"kernels\": [";
+            for (size_t i = 0; i < kernels.size(); ++i) {
+                const KernelResult &k = kernels[i];
+                o << (i ? "," : "") << "\n      {\"isa\": " << quote(k.isa) << ", \"bounds\": " << k.bounds
+                  << ", \"face_normals\": " << k.faceNormals << ", \"normalize\": " << k.normalize << "}";
+            }
+            o << "\n    ]\n  }";
+        }
+        o << "\n}\n";
+        return o.str();
+    }
+
+    /// 기준 파일과 모델 / 단계별 중앙값 비교. 회귀가 하나라도 있으면 false
+    bool checkBaseline(const std::string &path, const Options &opt, const std::vector<ModelResult> &models) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            std::cerr << "obj_bench: cannot read baseline " << path << "\n";
+            return false;
+        }
+        std::stringstream text;
+        text << in.rdbuf();
+        Json root;
+        if (!JsonReader(text.str()).parse(root) || !root.find("models")) {
+            std::cerr << "obj_bench: malformed baseline " << path << "\n";
+            return false;
+        }
+
+        // 정점 순서가 다르면 메쉬와 단계 시간이 모두 달라지므로 비교하지 않음 (order 가 없는 예전 파일은 first-use)
+        const Json *order = root.find("order");
+        const std::string baseOrder = order ? order->string : orderName(MeshOrder::FirstUse);
+        if (baseOrder != orderName(opt.order)) {
+            std::cerr << "[baseline] recorded with --order " << baseOrder << ", this run uses "
+                      << orderName(opt.order) << "\n";
+            return false;
+        }
+        // 삼각형 재배치 여부도 마찬가지 (키가 없는 예전 파일은 항상 켜진 상태로 기록됨)
+        const Json *optimize = root.find("optimize_order");
+        const bool baseOptimize = optimize ? optimize->number != 0.0 : true;
+        if (baseOptimize != opt.optimizeOrder) {
+            std::cerr << "[baseline] recorded " << (baseOptimize ? "with" : "without") << " --optimize-order, this run "
+                      << (opt.optimizeOrder ? "uses" : "does not use") << " it\n";
+            return false;
+        }
+
+        const double tolerance = opt.tolerance;
+        bool ok = true;
+        for (const ModelResult &m : models) {
+            const Json *base = nullptr;
+            for (const Json &b : root.find("models")->array) {
+                const Json *name = b.find("name");
+                if (name && name->string == m.name) base = &b;
+            }
+            if (!base) {
+                std::cerr << "[baseline] " << m.name << ": not in baseline, skipped\n";
+                continue;
+            }
+            // 결과 메쉬가 달라졌으면 시간 비교 이전에 실패
+            const Json *tris = base->find("triangles"), *verts = base->find("vertices");
+            if ((tris && size_t(tris->number) != m.triangles) || (verts && size_t(verts->number) != m.vertices)) {
+                std::cerr << "[baseline] " << m.name << ": mesh changed (" << m.triangles << " tris / "
+                          << m.vertices << " verts, baseline " << (tris ? tris->number : 0) << " / "
+                          << (verts ? verts->number : 0) << ")\n";
+                ok = false;
+            }
+            const Json *stages = base->find("stages");
+            for (size_t s = 0; stages && s < kStageCount; ++s) {
+                const Json *st = stages->find(kStages[s]);
+                const Json *med = st ? st->find("median") : nullptr;
+                if (!med) continue;
+                const double was = med->number, now = m.stages[s].median;
+                if (now > was * (1.0 + tolerance) && now - was > kMinRegressionMs) {
+                    std::fprintf(stderr, "[baseline] %s %s: %.3f ms -> %.3f ms (+%.0f%%, limit %.0f%%)\n",
+                                 m.name.c_str(), kStages[s], was, now, (now / was - 1.0) * 100.0, tolerance * 100.0);
+                    ok = false;
+                }
+            }
+        }
+        return ok;
+    }
+}
+
+int main(int argc, char **argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        auto next = [&]() -> const char * {
+            if (i + 1 >= argc) {
+                std::cerr << "obj_bench: " << a << " needs a value\n";
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        if (a == "--models") opt.modelDir = next();
+        else if (a == "--warmup") opt.warmup = std::max(0, std::atoi(next()));
+        else if (a == "--reps") opt.reps = std::max(1, std::atoi(next()));
+        else if (a == "--json") opt.jsonPath = next();
+        else if (a == "--baseline") opt.baselinePath = next();
+        else if (a == "--tolerance") opt.tolerance = std::atof(next());
+        else if (a == "--order") {
+            const std::string o = next();
+            if (o == "first-use") opt.order = MeshOrder::FirstUse;
+            else if (o == "morton") opt.order = MeshOrder::Morton;
+            else { usage(); return 2; }
+        }
+        else if (a == "--optimize-order") opt.optimizeOrder = true;
+        else if (a == "--threads") opt.threads = unsigned(std::max(0, std::atoi(next())));
+        else if (a == "--micro") opt.micro = true;
+        else if (a == "-h" || a == "--help") { usage(); return 0; }
+        else if (!a.empty() && a[0] == '-') { usage(); return 2; }
+        else opt.files.push_back(a);
+    }
+
+    // 경로를 안 주면 실행 파일 옆 res/models 의 번들 모델 (CMake 가 빌드 폴더로 복사해 둠)
+    if (opt.files.empty()) {
+        std::filesystem::path dir = opt.modelDir.empty()
+                                        ? std::filesystem::path(argv[0]).parent_path() / "res" / "models"
+                                        : std::filesystem::path(opt.modelDir);
+        for (const char *name : kDefaultModels) opt.files.push_back((dir / name).string());
+    }
+
+    std::vector<ModelResult> models;
+    std::vector<DedupResult> dedup;
+    for (const std::string &f : opt.files) {
+        std::cerr << "obj_bench: " << f << "\n";
+        ModelResult r;
+        if (!benchModel(f, opt, r)) return 1;
+        std::fprintf(stderr, "  parse %.1f MB: 1 thread %.2f ms, %u threads %.2f ms (x%.2f)\n", r.bytes / (1024.0 * 1024.0),
+                     r.parseOne.median, parseThreads(opt), r.parseN.median,
+                     r.parseN.median > 0 ? r.parseOne.median / r.parseN.median : 0.0);
+        // 재배치 비용 (load 시간) 과 효과 (ACMR) 를 나란히 — --optimize-order 유무로 두 번 돌려 비교
+        std::fprintf(stderr, "  optimize%s %.2f ms of %.2f ms total, ACMR %.3f -> %.3f\n",
+                     opt.optimizeOrder ? " (vcache)" : "", r.stages[kOptimizeStage].median, r.stages[kTotalStage].median,
+                     r.order.acmrBefore, r.order.acmrAfter);
+        models.push_back(r);
+        if (opt.micro) dedup.push_back(benchDedup(f, opt));
+    }
+    std::vector<KernelResult> kernels;
+    if (opt.micro) kernels = benchKernels(opt);
+
+    const std::string json = toJson(opt, models, dedup, kernels);
+    if (opt.jsonPath.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream out(opt.jsonPath, std::ios::binary);
+        out << json;
+        if (!out) {
+            std::cerr << "obj_bench: cannot write " << opt.jsonPath << "\n";
+            return 1;
+        }
+    }
+
+    if (!opt.baselinePath.empty() && !checkBaseline(opt.baselinePath, opt, models)) return 1;
+    return 0;
+}
@@ -0,0 +1,443 @@
+// obj_gen – 스케일링 테스트용 합성 OBJ 생성기 (1만 ~ 1억+ 삼각형).
+// 같은 옵션 + 시드면 어느 머신에서든 같은 파일: 난수는 splitmix64, 숫자 출력은 std::to_chars,
+// 좌표 계산은 IEEE 기본 연산 (+ - * / sqrt floor) 만 씀 → sin / cos / cbrt 도 libm 대신 아래 고정 다항식.
+// FMA 로 묶이면 반올림이 달라지므로 빌드에서 -ffp-contract=off (CMakeLists.txt)
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr double kPi = 3.14159265358979323846;
+
+    enum class Shape { Sphere, Terrain, Parts };
+    enum class FaceType { Tri, Quad, Ngon };
+
+    struct Options {
+        Shape shape = Shape::Sphere;
+        FaceType faces = FaceType::Tri;
+        uint64_t triangles = 100'000; // 삼각형 분할 후 기준 목표 (이상이 되는 가장 작은 격자)
+        uint64_t seed = 1;
+        bool normals = false;
+        bool uvs = false;
+        std::string out;
+    };
+
+    void usage() {
+        std::cerr <<
+            "usage: obj_gen [options] -o out.obj\n"
+            "  --shape sphere|terrain|parts   UV sphere, fBm heightfield, or many small disconnected spheres\n"
+            "  --triangles N                  target triangle count after triangulation (K/M/G suffix ok)\n"
+            "  --faces tri|quad|ngon          face type written (ngon = hexagon per grid cell)\n"
+            "  --normals / --uvs              also write vn / vt\n"
+            "  --seed S                       noise / placement seed (default 1)\n";
+    }
+
+    uint64_t splitmix64(uint64_t &state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    /// sin, cos (libm 마다 마지막 비트가 다르므로 직접 계산). x 를 π/2 배수 k 와 |y| ≤ π/4 로 나눈 뒤
+    /// fdlibm 의 __kernel_sin / __kernel_cos 다항식. 이 도구의 각도 범위 ([0, 2π]) 에서 오차 1e-16 수준
+    void sinCos(double x, double &s, double &c) {
+        constexpr double kPio2Hi = 1.57079632673412561417e+00; // π/2 의 상위 33비트 (k × 가 정확)
+        constexpr double kPio2Lo = 6.07710050650619224932e-11; // π/2 - kPio2Hi
+        constexpr double kTwoOverPi = 6.36619772367581382433e-01;
+        const double k = std::floor(x * kTwoOverPi + 0.5);
+        const double y = (x - k * kPio2Hi) - k * kPio2Lo;
+        const double z = y * y;
+        const double sy = y + y * z * (-1.66666666666666324348e-01 + z * (8.33333333332248946124e-03 +
+                          z * (-1.98412698298579493134e-04 + z * (2.75573137070700676789e-06 +
+                          z * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10)))));
+        const double cy = 1.0 - 0.5 * z + z * z * (4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03 +
+                          z * (2.48015872894767294178e-05 + z * (-2.75573143513906633035e-07 +
+                          z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11)))));
+        switch (int64_t(k) & 3) {
+            case 0: s = sy; c = cy; break;
+            case 1: s = cy; c = -sy; break;
+            case 2: s = -sy; c = -cy; break;
+            default: s = -cy; c = sy; break;
+        }
+    }
+
+    /// 세제곱근 (x > 0). 지수로 고른 시작값에서 뉴턴 반복 횟수를 고정
+    double cubeRoot(double x) {
+        int e = 0;
+        std::frexp(x, &e);
+        double y = std::ldexp(1.0, e / 3); // 참값의 1/2 ~ 2 배 안
+        for (int i = 0; i < 8; ++i) y -= (y * y * y - x) / (3.0 * y * y);
+        return y;
+    }
+
+    /// [0, 1) – 상위 53비트 사용
+    double unit(uint64_t &state) { return (splitmix64(state) >> 11) * (1.0 / 9007199254740992.0); }
+
+    /// 격자점 (x, z) 의 [0, 1) 값 (시드별로 다름)
+    double latticeValue(uint64_t seed, int64_t x, int64_t z) {
+        uint64_t s = seed ^ (uint64_t(x) * 0x9E3779B97F4A7C15ULL) ^ (uint64_t(z) * 0xC2B2AE3D27D4EB4FULL);
+        return unit(s);
+    }
+
+    double valueNoise(uint64_t seed, double x, double z) {
+        const double fx = std::floor(x), fz = std::floor(z);
+        const int64_t ix = int64_t(fx), iz = int64_t(fz);
+        double tx = x - fx, tz = z - fz;
+        tx = tx * tx * (3.0 - 2.0 * tx);
+        tz = tz * tz * (3.0 - 2.0 * tz);
+        const double a = latticeValue(seed, ix, iz), b = latticeValue(seed, ix + 1, iz);
+        const double c = latticeValue(seed, ix, iz + 1), d = latticeValue(seed, ix + 1, iz + 1);
+        return (a + (b - a) * tx) + ((c + (d - c) * tx) - (a + (b - a) * tx)) * tz;
+    }
+
+    /// 6 옥타브 fBm, 대략 [-0.25, 0.25]
+    double terrainHeight(uint64_t seed, double x, double z) {
+        double h = 0.0, amp = 0.5, freq = 2.0;
+        for (int o = 0; o < 6; ++o) {
+            h += amp * (valueNoise(seed + o, x * freq, z * freq) - 0.5);
+            amp *= 0.5;
+            freq *= 2.0;
+        }
+        return h * 0.5;
+    }
+
+    struct Point {
+        double px, py, pz;
+        double nx, ny, nz;
+    };
+
+    /// (행, 열) 매개변수 격자 위 곡면. pole 이면 첫 행 / 마지막 행이 한 점으로 모임 (UV 구)
+    struct Grid {
+        uint64_t rows = 1, cols = 1;
+        bool poles = false;
+        std::function<Point(double r, double c)> surface; // r ∈ [0, rows], c ∈ [0, cols]
+    };
+
+    /// 면 종류별 셀 하나의 삼각형 수 (극 셀은 한 변이 점이라 적음)
+    uint64_t gridTriangles(const Grid &g, FaceType faces) {
+        const uint64_t body = faces == FaceType::Ngon ? 4 : 2, cap = faces == FaceType::Ngon ? 2 : 1;
+        if (!g.poles) return g.rows * g.cols * body;
+        return (g.rows - 2) * g.cols * body + 2 * g.cols * cap;
+    }
+
+    /// 큰 버퍼에 모아 fwrite (1억 삼각형이면 수 GB)
+    class Writer {
+    public:
+        explicit Writer(std::FILE *f) : f_(f) { buf_.resize(size_t(4) << 20); }
+        ~Writer() { flush(); }
+
+        void text(const char *s) {
+            const size_t n = std::strlen(s);
+            reserve(n);
+            std::memcpy(buf_.data() + len_, s, n);
+            len_ += n;
+        }
+
+        void ch(char c) {
+            reserve(1);
+            buf_[len_++] = c;
+        }
+
+        void real(double v) {
+            reserve(32);
+            len_ = std::to_chars(buf_.data() + len_, buf_.data() + buf_.size(), float(v) + 0.0f, // -0 → 0
+                                 std::chars_format::fixed, 6).ptr - buf_.data();
+        }
+
+        void integer(uint64_t v) {
+            reserve(24);
+            len_ = std::to_chars(buf_.data() + len_, buf_.data() + buf_.size(), v).ptr - buf_.data();
+        }
+
+        void flush() {
+            if (len_ && std::fwrite(buf_.data(), 1, len_, f_) != len_) ok_ = false;
+            len_ = 0;
+        }
+
+        bool ok() const { return ok_; }
+
+    private:
+        void reserve(size_t n) {
+            if (len_ + n > buf_.size()) flush();
+        }
+
+        std::FILE *f_;
+        std::vector<char> buf_;
+        size_t len_ = 0;
+        bool ok_ = true;
+    };
+
+    class ObjWriter {
+    public:
+        ObjWriter(Writer &w, const Options &opt) : w_(w), opt_(opt) {}
+
+        /// 격자의 정점 (v / vn / vt 를 같은 순서로) 을 쓰고 면은 나중에 쓸 수 있게 시작 번호를 돌려줌
+        uint64_t vertices(const Grid &g) {
+            const uint64_t base = next_;
+            auto emit = [&](double r, double c) {
+                const Point p = g.surface(r, c);
+                w_.text("v ");
+                w_.real(p.px); w_.ch(' '); w_.real(p.py); w_.ch(' '); w_.real(p.pz); w_.ch('\n');
+                if (opt_.normals) {
+                    w_.text("vn ");
+                    w_.real(p.nx); w_.ch(' '); w_.real(p.ny); w_.ch(' '); w_.real(p.nz); w_.ch('\n');
+                }
+                if (opt_.uvs) {
+                    w_.text("vt ");
+                    w_.real(c / double(g.cols)); w_.ch(' '); w_.real(1.0 - r / double(g.rows)); w_.ch('\n');
+                }
+                ++next_;
+            };
+            for (uint64_t r = 0; r <= g.rows; ++r)
+                for (uint64_t c = 0; c <= g.cols; ++c) emit(double(r), double(c));
+            if (opt_.faces == FaceType::Ngon) {
+                for (uint64_t r = 0; r <= g.rows; ++r)
+                    for (uint64_t c = 0; c < g.cols; ++c) emit(double(r), c + 0.5);
+            }
+            return base;
+        }
+
+        /// 셀마다 반시계 방향 (바깥 / 위쪽에서 볼 때). 다각형은 첫 정점 기준 fan 으로 나뉘어도 퇴화하지 않는 순서로 씀
+        void faces(const Grid &g, uint64_t base) {
+            const uint64_t stride = g.cols + 1, mid = base + (g.rows + 1) * stride;
+            for (uint64_t r = 0; r < g.rows; ++r) {
+                const bool top = g.poles && r == 0, bottom = g.poles && r + 1 == g.rows;
+                for (uint64_t c = 0; c < g.cols; ++c) {
+                    const uint64_t v00 = base + r * stride + c, v01 = v00 + 1;
+                    const uint64_t v10 = v00 + stride, v11 = v10 + 1;
+                    const uint64_t mt = mid + r * g.cols + c, mb = mt + g.cols; // 위 / 아래 변 중점
+                    switch (opt_.faces) {
+                        case FaceType::Tri:
+                            if (!bottom) face({v00, v10, v11}); // 아래 극에서는 v10 = v11
+                            if (!top) face({v00, v11, v01});    // 위 극에서는 v00 = v01
+                            break;
+                        case FaceType::Quad:
+                            if (top) face({v00, v10, v11});
+                            else if (bottom) face({v00, v11, v01});
+                            else face({v00, v10, v11, v01});
+                            break;
+                        case FaceType::Ngon:
+                            if (top) face({v00, v10, mb, v11});
+                            else if (bottom) face({mt, v00, v10, v01});
+                            else face({mt, v00, v10, mb, v11, v01});
+                            break;
+                    }
+                }
+            }
+        }
+
+        uint64_t vertexCount() const { return next_; }
+
+    private:
+        void face(std::initializer_list<uint64_t> ids) {
+            w_.ch('f');
+            for (uint64_t id : ids) {
+                const uint64_t k = id + 1; // OBJ 는 1 부터
+                w_.ch(' ');
+                w_.integer(k);
+                if (opt_.uvs || opt_.normals) {
+                    w_.ch('/');
+                    if (opt_.uvs) w_.integer(k);
+                    if (opt_.normals) {
+                        w_.ch('/');
+                        w_.integer(k);
+                    }
+                }
+            }
+            w_.ch('\n');
+        }
+
+        Writer &w_;
+        const Options &opt_;
+        uint64_t next_ = 0;
+    };
+
+    /// 반지름 radius, 중심 (cx, cy, cz) 의 UV 구 (행 = 위도, 열 = 경도)
+    Grid sphere(uint64_t rows, double radius, double cx, double cy, double cz) {
+        Grid g;
+        g.rows = rows;
+        g.cols = 2 * rows;
+        g.poles = true;
+        const double dr = kPi / double(g.rows), dc = 2.0 * kPi / double(g.cols);
+        g.surface = [=](double r, double c) {
+            double sinT, cosT, sinP, cosP;
+            sinCos(r * dr, sinT, cosT);
+            sinCos(c * dc, sinP, cosP);
+            const double nx = sinT * cosP, ny = cosT, nz = -sinT * sinP;
+            return Point{cx + radius * nx, cy + radius * ny, cz + radius * nz, nx, ny, nz};
+        };
+        return g;
+    }
+
+    /// [-1, 1]² 위 fBm 높이장
+    Grid terrain(uint64_t cells, uint64_t seed) {
+        Grid g;
+        g.rows = g.cols = cells;
+        const double step = 2.0 / double(cells);
+        g.surface = [=](double r, double c) {
+            const double x = -1.0 + c * step, z = -1.0 + r * step;
+            // 노멀은 셀 크기의 중앙 차분
+            const double dx = terrainHeight(seed, x + step, z) - terrainHeight(seed, x - step, z);
+            const double dz = terrainHeight(seed, x, z + step) - terrainHeight(seed, x, z - step);
+            double nx = -dx, ny = 2.0 * step, nz = -dz;
+            const double len = std::sqrt(nx * nx + ny * ny + nz * nz);
+            return Point{x, terrainHeight(seed, x, z), z, nx / len, ny / len, nz / len};
+        };
+        return g;
+    }
+
+    /// 목표 이상이 되는 가장 작은 크기 (triangles(n) 은 n 에 대해 증가)
+    uint64_t smallestSize(uint64_t target, const std::function<uint64_t(uint64_t)> &triangles, uint64_t minSize) {
+        uint64_t lo = minSize, hi = minSize;
+        while (triangles(hi) < target) hi *= 2;
+        while (lo < hi) {
+            uint64_t m = lo + (hi - lo) / 2;
+            if (triangles(m) < target) lo = m + 1;
+            else hi = m;
+        }
+        return lo;
+    }
+
+    bool parseCount(const char *s, uint64_t &out) {
+        char *end = nullptr;
+        const double v = std::strtod(s, &end);
+        if (end == s || v <= 0.0) return false;
+        double mul = 1.0;
+        switch (*end) {
+            case 'k': case 'K': mul = 1e3; ++end; break;
+            case 'm': case 'M': mul = 1e6; ++end; break;
+            case 'g': case 'G': mul = 1e9; ++end; break;
+            default: break;
+        }
+        if (*end) return false;
+        out = uint64_t(v * mul + 0.5);
+        return true;
+    }
+}
+
+int main(int argc, char **argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        auto next = [&]() -> const char * {
+            if (i + 1 >= argc) {
+                std::cerr << "obj_gen: " << a << " needs a value\n";
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        if (a == "--shape") {
+            const std::string s = next();
+            if (s == "sphere") opt.shape = Shape::Sphere;
+            else if (s == "terrain") opt.shape = Shape::Terrain;
+            else if (s == "parts") opt.shape = Shape::Parts;
+            else { usage(); return 2; }
+        } else if (a == "--faces") {
+            const std::string s = next();
+            if (s == "tri") opt.faces = FaceType::Tri;
+            else if (s == "quad") opt.faces = FaceType::Quad;
+            else if (s == "ngon") opt.faces = FaceType::Ngon;
+            else { usage(); return 2; }
+        } else if (a == "--triangles") {
+            if (!parseCount(next(), opt.triangles)) { usage(); return 2; }
+        } else if (a == "--seed") {
+            opt.seed = std::strtoull(next(), nullptr, 10);
+        } else if (a == "--normals") {
+            opt.normals = true;
+        } else if (a == "--uvs") {
+            opt.uvs = true;
+        } else if (a == "-o" || a == "--out") {
+            opt.out = next();
+        } else if (a == "-h" || a == "--help") {
+            usage();
+            return 0;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (opt.out.empty()) {
+        usage();
+        return 2;
+    }
+
+    std::FILE *f = std::fopen(opt.out.c_str(), "wb");
+    if (!f) {
+        std::cerr << "obj_gen: cannot write " << opt.out << "\n";
+        return 1;
+    }
+
+    uint64_t triangles = 0, vertices = 0, parts = 1;
+    bool ok = true;
+    {
+        Writer w(f);
+        ObjWriter obj(w, opt);
+        // 출력 경로와 인자 순서는 넣지 않음 (같은 옵션이면 같은 바이트)
+        const char *const shapes[] = {"sphere", "terrain", "parts"}, *const faces[] = {"tri", "quad", "ngon"};
+        w.text("# obj_gen --shape ");
+        w.text(shapes[int(opt.shape)]);
+        w.text(" --faces ");
+        w.text(faces[int(opt.faces)]);
+        w.text(" --triangles ");
+        w.integer(opt.triangles);
+        w.text(" --seed ");
+        w.integer(opt.seed);
+        if (opt.normals) w.text(" --normals");
+        if (opt.uvs) w.text(" --uvs");
+        w.ch('\n');
+
+        switch (opt.shape) {
+            case Shape::Sphere: {
+                const uint64_t rows = smallestSize(opt.triangles, [&](uint64_t n) {
+                    return gridTriangles(sphere(n, 1.0, 0, 0, 0), opt.faces);
+                }, 3);
+                const Grid g = sphere(rows, 1.0, 0, 0, 0);
+                obj.faces(g, obj.vertices(g));
+                triangles = gridTriangles(g, opt.faces);
+                break;
+            }
+            case Shape::Terrain: {
+                const uint64_t cells = smallestSize(opt.triangles, [&](uint64_t n) {
+                    return gridTriangles(terrain(n, opt.seed), opt.faces);
+                }, 1);
+                const Grid g = terrain(cells, opt.seed);
+                obj.faces(g, obj.vertices(g));
+                triangles = gridTriangles(g, opt.faces);
+                break;
+            }
+            case Shape::Parts: {
+                // 작은 구 (6 × 12 셀) 를 [-1, 1]³ 에 흩뿌림. 부품마다 정점 → 면 순서로 써서 메모리를 쓰지 않음
+                const uint64_t perPart = gridTriangles(sphere(6, 1.0, 0, 0, 0), opt.faces);
+                parts = (opt.triangles + perPart - 1) / perPart;
+                const double radius = 0.5 / cubeRoot(double(parts)); // 부품 수에 맞춰 밀도 유지
+                uint64_t rng = opt.seed;
+                for (uint64_t p = 0; p < parts; ++p) {
+                    const double cx = unit(rng) * 2.0 - 1.0, cy = unit(rng) * 2.0 - 1.0, cz = unit(rng) * 2.0 - 1.0;
+                    const double r = radius * (0.5 + unit(rng));
+                    const Grid g = sphere(6, r, cx, cy, cz);
+                    obj.faces(g, obj.vertices(g));
+                }
+                triangles = parts * perPart;
+                break;
+            }
+        }
+        vertices = obj.vertexCount();
+        w.flush();
+        ok = w.ok();
+    }
+    if (std::fclose(f) != 0 || !ok) {
+        std::cerr << "obj_gen: write failed for " << opt.out << "\n";
+        return 1;
+    }
+    std::cerr << "obj_gen: " << opt.out << ": " << triangles << " triangles, " << vertices << " vertices"
+              << (opt.shape == Shape::Parts ? ", " + std::to_string(parts) + " parts" : std::string()) << "\n";
+    return 0;
+}
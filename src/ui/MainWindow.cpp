@@ -5,9 +5,16 @@
 #include <QLabel>
 #include <QHBoxLayout>
 #include <QButtonGroup>
+#include <QCheckBox>
 #include <QStatusBar>
 #include <QSlider>
 #include <QDoubleSpinBox>
+#include <QAction>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QMenuBar>
+#include <QProgressBar>
+#include <QPushButton>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent) {
@@ -39,6 +46,15 @@ MainWindow::MainWindow(QWidget *parent)
     hbox->addStretch(); // 오른쪽 여백
 
     modelLayout->addLayout(hbox); // 세로 레이아웃에 삽입
+
+    /* VBO 레이아웃 : 32 B float ↔ 12 B 양자화 */
+    auto *compactCheck = new QCheckBox("Compact vertices (12 B)");
+    modelLayout->addWidget(compactCheck);
+    auto *coneCheck = new QCheckBox("Cull back-facing meshlets");
+    modelLayout->addWidget(coneCheck);
+    auto *orderCheck = new QCheckBox("Optimize triangle order");
+    orderCheck->setToolTip(tr("Reorders triangles for the GPU vertex cache; applies to the next model opened and slows loading"));
+    modelLayout->addWidget(orderCheck);
     modelLayout->addStretch(); // 아래쪽 빈 공간
 
     /* 버튼 그룹 & 시그널 연결 */
@@ -89,8 +105,25 @@ MainWindow::MainWindow(QWidget *parent)
     lightingLayout->addWidget(new QLabel("Shininess"));
     lightingLayout->addWidget(shinSpin);
 
+    // Rendering : 기본은 상태가 바뀔 때만 그림
+    auto *renderGroup = new QWidget;
+    auto *renderLayout = new QVBoxLayout(renderGroup);
+    renderLayout->addWidget(new QLabel("<b>Rendering</b>"));
+    auto *continuousCheck = new QCheckBox("Continuous (benchmark)");
+    renderLayout->addWidget(continuousCheck);
+    auto *fpsSpin = new QSpinBox;
+    fpsSpin->setRange(0, 240);
+    fpsSpin->setValue(0);
+    fpsSpin->setSpecialValueText(tr("Unlimited"));
+    renderLayout->addWidget(new QLabel("FPS cap"));
+    renderLayout->addWidget(fpsSpin);
+    auto *leanCheck = new QCheckBox("Free CPU mesh copies after upload");
+    leanCheck->setToolTip(tr("Keeps only what picking needs; re-uploads reload from the mesh cache"));
+    renderLayout->addWidget(leanCheck);
+
     mainLayout->addWidget(modelGroup);
     mainLayout->addWidget(lightingGroup);
+    mainLayout->addWidget(renderGroup);
 
     dock->setWidget(mainPanel);
     addDockWidget(Qt::RightDockWidgetArea, dock);
@@ -98,9 +131,18 @@ MainWindow::MainWindow(QWidget *parent)
     connect(group, QOverload<int>::of(&QButtonGroup::idClicked),
             this, [this](int id) {
                 auto mode = (id == 0) ? NormalMode::Vertex : NormalMode::Face;
-                glWidget_->setNormalMode(mode); // GLWidget 내부에서 rebuild + GPU 업로드
+                glWidget_->setNormalMode(mode); // 셰이더 uniform 만 전환 (재업로드 없음)
             });
 
+    connect(compactCheck, &QCheckBox::toggled, this, [this](bool on) {
+        glWidget_->setVertexFormat(on ? VertexFormat::Packed : VertexFormat::Float32);
+    });
+    connect(coneCheck, &QCheckBox::toggled, glWidget_, &GLWidget::setConeCulling);
+    connect(orderCheck, &QCheckBox::toggled, glWidget_, &GLWidget::setOptimizeOrder);
+    connect(continuousCheck, &QCheckBox::toggled, glWidget_, &GLWidget::setContinuousRendering);
+    connect(fpsSpin, QOverload<int>::of(&QSpinBox::valueChanged), glWidget_, &GLWidget::setFrameRateCap);
+    connect(leanCheck, &QCheckBox::toggled, glWidget_, &GLWidget::setLeanMemory);
+
     /* signal-slot 연결 */
     connect(yawSlider, &QSlider::valueChanged, glWidget_, &GLWidget::setLightYaw);
     connect(pitchSlider, &QSlider::valueChanged, glWidget_, &GLWidget::setLightPitch);
@@ -112,8 +154,62 @@ MainWindow::MainWindow(QWidget *parent)
             glWidget_, &GLWidget::setShininess);
 
 
-    // 상태바 등 추가도 가능
-    //statusBar()->showMessage("Ready", 3000);
+    // 파일 메뉴
+    auto *fileMenu = menuBar()->addMenu(tr("&File"));
+    auto *openAct = fileMenu->addAction(tr("&Open..."));
+    openAct->setShortcut(QKeySequence::Open);
+    connect(openAct, &QAction::triggered, this, [this] {
+        QString path = QFileDialog::getOpenFileName(this, tr("Open Model"), QString(),
+                                                    tr("Wavefront OBJ (*.obj)"));
+        if (!path.isEmpty()) glWidget_->openModel(path);
+    });
+    auto *exportAct = fileMenu->addAction(tr("Export &Frame Timings..."));
+    connect(exportAct, &QAction::triggered, this, [this] {
+        QString path = QFileDialog::getSaveFileName(this, tr("Export Frame Timings"), "frame_timings.csv",
+                                                    tr("CSV (*.csv)"));
+        if (path.isEmpty()) return;
+        statusBar()->showMessage(glWidget_->exportFrameTimings(path)
+                                     ? tr("Saved %1").arg(QFileInfo(path).fileName())
+                                     : tr("Could not write %1").arg(path), 5000);
+    });
+
+    // 상태바: 로드 진행률 + 취소
+    auto *progress = new QProgressBar;
+    progress->setRange(0, 100);
+    progress->setMaximumWidth(200);
+    auto *cancelBtn = new QPushButton(tr("Cancel"));
+    statusBar()->addPermanentWidget(progress);
+    statusBar()->addPermanentWidget(cancelBtn);
+    progress->hide();
+    cancelBtn->hide();
+
+    connect(cancelBtn, &QPushButton::clicked, glWidget_, &GLWidget::cancelLoad);
+    connect(glWidget_, &GLWidget::loadStarted, this, [this, progress, cancelBtn](const QString &path) {
+        progress->setValue(0);
+        progress->show();
+        cancelBtn->show();
+        statusBar()->showMessage(tr("Loading %1...").arg(QFileInfo(path).fileName()));
+    });
+    connect(glWidget_, &GLWidget::loadProgress, this, [this, progress](int pct, const QString &stage) {
+        progress->setValue(pct);
+        statusBar()->showMessage(stage);
+    });
+    connect(glWidget_, &GLWidget::loadFinished, this, [this, progress, cancelBtn](bool, const QString &msg) {
+        progress->hide();
+        cancelBtn->hide();
+        statusBar()->showMessage(msg, 5000);
+    });
+    connect(glWidget_, &GLWidget::statusMessage, this, [this](const QString &msg) {
+        statusBar()->showMessage(msg, 10000);
+    });
+
+    // 상태바 오른쪽: 메모리 요약 (툴팁에 배열별 / GPU 버퍼별 내역)
+    auto *memLabel = new QLabel;
+    statusBar()->addPermanentWidget(memLabel);
+    connect(glWidget_, &GLWidget::memoryChanged, this, [this, memLabel](const QString &summary) {
+        memLabel->setText(summary);
+        memLabel->setToolTip("<pre>" + glWidget_->memoryReport().toHtmlEscaped() + "</pre>");
+    });
 
     qDebug() << "glWidget_ =" << glWidget_;
 }